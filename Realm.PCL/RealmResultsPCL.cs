@@ -39,26 +39,89 @@ public class RealmResults<T> : IQueryable<T>
         public class ChangeSet
         {
             /// <summary>
-            /// The indices in the new version of the <see cref="RealmResults{T}" /> which were newly inserted.
+            /// A contiguous run of indices in a <see cref="ChangeSet"/>, from <see cref="Begin"/> up to but not including <see cref="End"/>.
             /// </summary>
-            public readonly int[] InsertedIndices;
+            public struct IndexRange
+            {
+                /// <summary>
+                /// The first index in the range.
+                /// </summary>
+                public readonly int Begin;
+
+                /// <summary>
+                /// One past the last index in the range.
+                /// </summary>
+                public readonly int End;
+
+                internal IndexRange(int begin, int end)
+                {
+                    Begin = begin;
+                    End = end;
+                }
+            }
+
+            /// <summary>
+            /// The indices in the new version of the <see cref="RealmResults{T}" /> which were newly inserted, as sorted non-overlapping ranges.
+            /// </summary>
+            public readonly IndexRange[] InsertedRanges;
+
+            /// <summary>
+            /// The indices in the new version of the <see cref="RealmResults{T}"/> which were modified, as sorted non-overlapping ranges.
+            /// This means that the property of an object at that index was modified or the property of another object it's related to.
+            /// </summary>
+            public readonly IndexRange[] ModifiedRanges;
+
+            /// <summary>
+            /// The indices of objects in the previous version of the <see cref="RealmResults{T}"/> which have been removed from this one,
+            /// as sorted non-overlapping ranges.
+            /// </summary>
+            public readonly IndexRange[] DeletedRanges;
+
+            /// <summary>
+            /// The same indices as <see cref="InsertedRanges"/>, expanded into an array of every index the first time this is read.
+            /// </summary>
+            /// <remarks>Prefer <see cref="InsertedRanges"/> when large numbers of objects may have changed.</remarks>
+            public int[] InsertedIndices
+            {
+                get
+                {
+                    RealmPCLHelpers.ThrowProxyShouldNeverBeUsed();
+                    return null;
+                }
+            }
 
             /// <summary>
-            /// The indices in the new version of the <see cref="RealmResults{T}"/> which were modified. This means that the property of an object at that index was modified
-            /// or the property of another object it's related to.
+            /// The same indices as <see cref="ModifiedRanges"/>, expanded into an array of every index the first time this is read.
             /// </summary>
-            public readonly int[] ModifiedIndices;
+            /// <remarks>Prefer <see cref="ModifiedRanges"/> when large numbers of objects may have changed.</remarks>
+            public int[] ModifiedIndices
+            {
+                get
+                {
+                    RealmPCLHelpers.ThrowProxyShouldNeverBeUsed();
+                    return null;
+                }
+            }
 
             /// <summary>
-            /// The indices of objects in the previous version of the <see cref="RealmResults{T}"/> which have been removed from this one.
+            /// The same indices as <see cref="DeletedRanges"/>, expanded into an array of every index the first time this is read.
             /// </summary>
-            public readonly int[] DeletedIndices;
+            /// <remarks>Prefer <see cref="DeletedRanges"/> when large numbers of objects may have changed,
+            /// such as when every object in the <see cref="RealmResults{T}"/> has been deleted.</remarks>
+            public int[] DeletedIndices
+            {
+                get
+                {
+                    RealmPCLHelpers.ThrowProxyShouldNeverBeUsed();
+                    return null;
+                }
+            }
 
-            internal ChangeSet(int[] insertedIndices, int[] modifiedIndices, int[] deletedIndices)
+            internal ChangeSet(IndexRange[] insertedRanges, IndexRange[] modifiedRanges, IndexRange[] deletedRanges)
             {
-                InsertedIndices = insertedIndices;
-                ModifiedIndices = modifiedIndices;
-                DeletedIndices = deletedIndices;
+                InsertedRanges = insertedRanges;
+                ModifiedRanges = modifiedRanges;
+                DeletedRanges = deletedRanges;
             }
         }
 
@@ -91,6 +154,25 @@ IEnumerator IEnumerable.GetEnumerator()
         }
 
 
+        /// <summary>
+        /// Calculates several aggregates of the properties of the objects in this <see cref="RealmResults{T}"/> with a single call.
+        /// </summary>
+        /// <remarks>
+        /// The objects are only read once for all of the aggregates, rather than once per aggregate as when they are calculated separately with LINQ.
+        /// </remarks>
+        /// <param name="aggregates">The name of the property and the operation for each aggregate to calculate.</param>
+        /// <returns>
+        /// The value of each aggregate, in the same order as <paramref name="aggregates"/>. Counts, and the sum, minimum and maximum of integer properties, are <c>long</c>.
+        /// Averages and the sums of <c>float</c> and <c>double</c> properties are <c>double</c>. Other minimums and maximums have the type of the property.
+        /// The minimum, maximum and average of no values are <c>null</c>.
+        /// </returns>
+        /// <exception cref="ArgumentException">If <typeparamref name="T"/> has no property with one of the names.</exception>
+        public object[] Aggregate(params Tuple<string, AggregateOperation>[] aggregates)
+        {
+            RealmPCLHelpers.ThrowProxyShouldNeverBeUsed();
+            return null;
+        }
+
         /// <summary>
         /// Count all objects if created by <see cref="Realm.All"/> of the parameterised type, faster than a search.
         /// </summary>
@@ -138,5 +220,25 @@ public IDisposable SubscribeForNotifications(NotificationCallback callback)
             RealmPCLHelpers.ThrowProxyShouldNeverBeUsed();
             return null;
         }
+
+        /// <summary>
+        /// Register a callback to be invoked each time this <see cref="RealmResults{T}"/> changes, with the given priority.
+        /// </summary>
+        /// <remarks>
+        /// This behaves the same as <see cref="SubscribeForNotifications(NotificationCallback)"/>, except that the results are recalculated after each
+        /// write transaction according to <paramref name="priority"/>. All of the callbacks for a <see cref="RealmResults{T}"/> share one subscription,
+        /// which always uses the highest priority of the callbacks currently registered.
+        /// </remarks>
+        /// <param name="callback">The callback to be invoked with the updated <see cref="RealmResults{T}" />.</param>
+        /// <param name="priority">How urgently the notifications are needed.</param>
+        /// <returns>
+        /// A subscription token. It must be kept alive for as long as you want to receive change notifications.
+        /// To stop receiving notifications, call <see cref="IDisposable.Dispose" />.
+        /// </returns>
+        public IDisposable SubscribeForNotifications(NotificationCallback callback, NotificationPriority priority)
+        {
+            RealmPCLHelpers.ThrowProxyShouldNeverBeUsed();
+            return null;
+        }
     }
 }
\ No newline at end of file
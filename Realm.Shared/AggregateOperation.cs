@@ -0,0 +1,54 @@
+﻿////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+namespace Realms
+{
+    /// <summary>
+    /// An aggregate which <see cref="RealmResults{T}.Aggregate"/> can calculate over a property.
+    /// </summary>
+    /// <remarks>
+    /// Null values are ignored by all of the operations. <see cref="Sum"/> and <see cref="Average"/> can't be used with <c>DateTimeOffset</c> properties.
+    /// </remarks>
+    public enum AggregateOperation
+    {
+        /// <summary>
+        /// The number of non-null values.
+        /// </summary>
+        Count,
+
+        /// <summary>
+        /// The smallest value.
+        /// </summary>
+        Min,
+
+        /// <summary>
+        /// The largest value.
+        /// </summary>
+        Max,
+
+        /// <summary>
+        /// The sum of the values.
+        /// </summary>
+        Sum,
+
+        /// <summary>
+        /// The mean of the values.
+        /// </summary>
+        Average
+    }
+}
@@ -0,0 +1,46 @@
+﻿////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+namespace Realms
+{
+    /// <summary>
+    /// How urgently the change notifications for a <see cref="RealmResults{T}"/> are needed.
+    /// </summary>
+    /// <remarks>
+    /// After each write transaction the results with <see cref="High"/> priority are recalculated and their notifications delivered first,
+    /// followed by those with <see cref="Normal"/> priority. Results with <see cref="Background"/> priority are only recalculated once all of the others
+    /// have been delivered, so a slow query can't delay the notifications for the collections being displayed.
+    /// </remarks>
+    public enum NotificationPriority : byte
+    {
+        /// <summary>
+        /// For results which are currently visible to the user.
+        /// </summary>
+        High,
+
+        /// <summary>
+        /// The default priority.
+        /// </summary>
+        Normal,
+
+        /// <summary>
+        /// For results which are being prefetched or analysed, and can wait for everything else.
+        /// </summary>
+        Background
+    }
+}
@@ -62,6 +62,7 @@ static Realm()
             ObjectSchemaCache = new Dictionary<Type, IntPtr>();
             NativeCommon.Initialize();
             NativeCommon.register_notify_realm_changed(NotifyRealmChanged);
+            NativeCommon.register_notify_results_batch(RealmResultsNativeHelper.BatchNotificationCallback);
         }
 
         #if __IOS__
@@ -169,6 +170,9 @@ public static Realm GetInstance(RealmConfiguration config=null)
                 srHandle.SetHandle(srPtr);
             }
 
+            // deliver all the RealmResults notifications which are ready together with a single call into managed code
+            NativeSharedRealm.set_batch_notifications(srHandle, (IntPtr)1);
+
             return new Realm(srHandle, config);
         } 
 
@@ -256,16 +260,34 @@ private RealmObject.Metadata CreateRealmObjectMetadata(Type realmObjectType)
 
                                                 return p.Name;
                                             })
-                                            .ToDictionary(name => name, name => NativeTable.get_column_index(table, name, (IntPtr)name.Length));
+                                            .ToArray();
 
             return new RealmObject.Metadata
             {
                 Table = table,
                 Helper = helper,
-                ColumnIndices = properties
+                ColumnIndices = GetColumnIndices(realmObjectType.Name, properties)
             };
         }
 
+        // Resolves the column index of every property with one call, rather than one call per property. The names are
+        // resolved natively, so the indices don't depend on the order the properties were added to the schema in.
+        private Dictionary<string, IntPtr> GetColumnIndices(string objectType, string[] propertyNames)
+        {
+            var columnIndices = new IntPtr[propertyNames.Length];
+            var nameLengths = propertyNames.Select(name => (IntPtr)name.Length).ToArray();
+            UInt64 schemaVersion;
+            var count = (int)NativeSharedRealm.get_column_map(SharedRealmHandle, objectType, (IntPtr)objectType.Length,
+                string.Concat(propertyNames), nameLengths, (IntPtr)propertyNames.Length, columnIndices, out schemaVersion);
+            if (count != columnIndices.Length)
+                throw new RealmException($"The schema for {objectType} has {count} properties but the class has {columnIndices.Length}.");
+
+            var indices = new Dictionary<string, IntPtr>(columnIndices.Length);
+            for (var i = 0; i < columnIndices.Length; i++)
+                indices[propertyNames[i]] = columnIndices[i];
+            return indices;
+        }
+
         /// <summary>
         /// Handler type used by <see cref="RealmChanged"/> 
         /// </summary>
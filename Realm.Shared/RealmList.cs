@@ -49,20 +49,14 @@ internal RealmListEnumerator(RealmList<T> parent)
             /// Return the current related object when iterating a related set.
             /// </summary>
             /// <exception cref="IndexOutOfRangeException">When we are not currently pointing at a valid item, either MoveNext has not been called for the first time or have iterated through all the items.</exception>
-            public T Current
-            {
-                get
-                {
-                    return enumerating[index];
-                }
-            }
+            public T Current { get; private set; }
 
             // also needed - https://msdn.microsoft.com/en-us/library/s793z9y2.aspx
             object IEnumerator.Current
             {
                 get
                 {
-                    return enumerating[index];
+                    return Current;
                 }
             }
 
@@ -73,8 +67,16 @@ object IEnumerator.Current
             public bool MoveNext()
             {
                 index++;
-                if (index >= enumerating.Count)
+                IntPtr rowPtr;
+                // fetches the row and checks the bounds in one call, without an exception at the end
+                var status = NativeLinkList.try_get(enumerating._listHandle, (IntPtr)index, out rowPtr);
+                NativeCommon.ThrowIfError(status);
+                if (status != NativeStatus.Ok)
+                {
+                    Current = null;
                     return false;
+                }
+                Current = (T)enumerating._parent.MakeRealmObject(typeof(T), rowPtr);
                 return true;
             }
 
@@ -84,6 +86,7 @@ public bool MoveNext()
             public void Reset()
             {
                 index = -1;  // by definition BEFORE first item
+                Current = null;
             }
 
             /// <summary>
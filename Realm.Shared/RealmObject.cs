@@ -337,7 +337,10 @@ protected DateTimeOffset GetDateTimeOffsetValue(string propertyName)
             Debug.Assert(_realm != null, "Object is not managed, but managed access was attempted");
 
             var rowIndex = _rowHandle.RowIndex;
-            var linkedRowPtr = NativeTable.get_link (_metadata.Table, _metadata.ColumnIndices[propertyName], (IntPtr)rowIndex);
+            IntPtr linkedRowPtr;
+            // a null link is reported as NotFound, which leaves linkedRowPtr null
+            var status = NativeTable.try_get_link (_metadata.Table, _metadata.ColumnIndices[propertyName], (IntPtr)rowIndex, out linkedRowPtr);
+            NativeCommon.ThrowIfError(status);
             return (T)MakeRealmObject(typeof(T), linkedRowPtr);
         }
 
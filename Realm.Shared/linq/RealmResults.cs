@@ -43,7 +43,11 @@ public class RealmResults<T> : IOrderedQueryable<T>, RealmResultsNativeHelper.In
         private readonly bool _allRecords = false;
         private readonly Realm _realm;
         private readonly List<NotificationCallback> _callbacks = new List<NotificationCallback>();
+        private readonly List<NotificationPriority> _callbackPriorities = new List<NotificationPriority>();  // parallel to _callbacks
         private NotificationTokenHandle _notificationToken;
+        private NotificationPriority _notificationPriority;
+        private bool _receivedInitialNotification;
+        private bool _skipInitialNotification;
 
         internal ResultsHandle ResultsHandle => _resultsHandle ?? (_resultsHandle = CreateResultsHandle()); 
         private ResultsHandle _resultsHandle = null;
@@ -56,26 +60,96 @@ public class RealmResults<T> : IOrderedQueryable<T>, RealmResultsNativeHelper.In
         public class ChangeSet
         {
             /// <summary>
-            /// The indices in the new version of the <see cref="RealmResults{T}" /> which were newly inserted.
+            /// A contiguous run of indices in a <see cref="ChangeSet"/>, from <see cref="Begin"/> up to but not including <see cref="End"/>.
             /// </summary>
-            public readonly int[] InsertedIndices;
+            public struct IndexRange
+            {
+                /// <summary>
+                /// The first index in the range.
+                /// </summary>
+                public readonly int Begin;
+
+                /// <summary>
+                /// One past the last index in the range.
+                /// </summary>
+                public readonly int End;
+
+                internal IndexRange(int begin, int end)
+                {
+                    Begin = begin;
+                    End = end;
+                }
+            }
+
+            /// <summary>
+            /// The indices in the new version of the <see cref="RealmResults{T}" /> which were newly inserted, as sorted non-overlapping ranges.
+            /// </summary>
+            public readonly IndexRange[] InsertedRanges;
+
+            /// <summary>
+            /// The indices in the new version of the <see cref="RealmResults{T}"/> which were modified, as sorted non-overlapping ranges.
+            /// This means that the property of an object at that index was modified or the property of another object it's related to.
+            /// </summary>
+            public readonly IndexRange[] ModifiedRanges;
+
+            /// <summary>
+            /// The indices of objects in the previous version of the <see cref="RealmResults{T}"/> which have been removed from this one,
+            /// as sorted non-overlapping ranges.
+            /// </summary>
+            public readonly IndexRange[] DeletedRanges;
+
+            private int[] _insertedIndices;
+            private int[] _modifiedIndices;
+            private int[] _deletedIndices;
+
+            /// <summary>
+            /// The same indices as <see cref="InsertedRanges"/>, expanded into an array of every index the first time this is read.
+            /// </summary>
+            /// <remarks>Prefer <see cref="InsertedRanges"/> when large numbers of objects may have changed.</remarks>
+            public int[] InsertedIndices => _insertedIndices ?? (_insertedIndices = ExpandRanges(InsertedRanges));
 
             /// <summary>
-            /// The indices in the new version of the <see cref="RealmResults{T}"/> which were modified. This means that the property of an object at that index was modified
-            /// or the property of another object it's related to.
+            /// The same indices as <see cref="ModifiedRanges"/>, expanded into an array of every index the first time this is read.
             /// </summary>
-            public readonly int[] ModifiedIndices;
+            /// <remarks>Prefer <see cref="ModifiedRanges"/> when large numbers of objects may have changed.</remarks>
+            public int[] ModifiedIndices => _modifiedIndices ?? (_modifiedIndices = ExpandRanges(ModifiedRanges));
 
             /// <summary>
-            /// The indices of objects in the previous version of the <see cref="RealmResults{T}"/> which have been removed from this one.
+            /// The same indices as <see cref="DeletedRanges"/>, expanded into an array of every index the first time this is read.
             /// </summary>
-            public readonly int[] DeletedIndices;
+            /// <remarks>Prefer <see cref="DeletedRanges"/> when large numbers of objects may have changed,
+            /// such as when every object in the <see cref="RealmResults{T}"/> has been deleted.</remarks>
+            public int[] DeletedIndices => _deletedIndices ?? (_deletedIndices = ExpandRanges(DeletedRanges));
 
-            internal ChangeSet(int[] insertedIndices, int[] modifiedIndices, int[] deletedIndices)
+            internal ChangeSet(NativeResults.IndexRange[] insertedRanges, NativeResults.IndexRange[] modifiedRanges, NativeResults.IndexRange[] deletedRanges)
             {
-                InsertedIndices = insertedIndices;
-                ModifiedIndices = modifiedIndices;
-                DeletedIndices = deletedIndices;
+                InsertedRanges = ToPublicRanges(insertedRanges);
+                ModifiedRanges = ToPublicRanges(modifiedRanges);
+                DeletedRanges = ToPublicRanges(deletedRanges);
+            }
+
+            private static IndexRange[] ToPublicRanges(NativeResults.IndexRange[] ranges)
+            {
+                var result = new IndexRange[ranges.Length];
+                for (var i = 0; i < ranges.Length; i++)
+                    result[i] = new IndexRange((int)ranges[i].Begin, (int)ranges[i].End);
+                return result;
+            }
+
+            private static int[] ExpandRanges(IndexRange[] ranges)
+            {
+                var count = 0;
+                foreach (var range in ranges)
+                    count += range.End - range.Begin;
+
+                var indices = new int[count];
+                var pos = 0;
+                foreach (var range in ranges)
+                {
+                    for (var i = range.Begin; i < range.End; i++)
+                        indices[pos++] = i;
+                }
+                return indices;
             }
         }
 
@@ -158,6 +232,36 @@ public int Count()
             return (int)NativeResults.count(ResultsHandle);
         }
 
+        /// <summary>
+        /// Calculates several aggregates of the properties of the objects in this <see cref="RealmResults{T}"/> with a single call.
+        /// </summary>
+        /// <remarks>
+        /// The objects are only read once for all of the aggregates, rather than once per aggregate as when they are calculated separately with LINQ.
+        /// </remarks>
+        /// <param name="aggregates">The name of the property and the operation for each aggregate to calculate.</param>
+        /// <returns>
+        /// The value of each aggregate, in the same order as <paramref name="aggregates"/>. Counts, and the sum, minimum and maximum of integer properties, are <c>long</c>.
+        /// Averages and the sums of <c>float</c> and <c>double</c> properties are <c>double</c>. Other minimums and maximums have the type of the property.
+        /// The minimum, maximum and average of no values are <c>null</c>.
+        /// </returns>
+        /// <exception cref="ArgumentException">If <typeparamref name="T"/> has no property with one of the names.</exception>
+        public object[] Aggregate(params Tuple<string, AggregateOperation>[] aggregates)
+        {
+            var metadata = _realm.Metadata[ElementType];
+            var requests = new NativeResults.AggregateRequest[aggregates.Length];
+            for (var i = 0; i < aggregates.Length; i++)
+            {
+                IntPtr columnIndex;
+                if (!metadata.ColumnIndices.TryGetValue(aggregates[i].Item1, out columnIndex))
+                    throw new ArgumentException($"{ElementType.Name} has no property named {aggregates[i].Item1}", nameof(aggregates));
+                requests[i] = new NativeResults.AggregateRequest((int)columnIndex, (NativeResults.AggregateOp)aggregates[i].Item2);
+            }
+
+            var results = new NativeResults.AggregateResult[requests.Length];
+            NativeResults.aggregate_many(ResultsHandle, requests, (IntPtr)requests.Length, results);
+            return results.Select(result => result.ToObject()).ToArray();
+        }
+
         class NotificationToken : IDisposable
         {
             RealmResults<T> _results;
@@ -208,24 +312,77 @@ public void Dispose()
         /// </returns>
         public IDisposable SubscribeForNotifications(NotificationCallback callback)
         {
-            if (_callbacks.Count == 0)
+            return SubscribeForNotifications(callback, NotificationPriority.Normal);
+        }
+
+        /// <summary>
+        /// Register a callback to be invoked each time this <see cref="RealmResults{T}"/> changes, with the given priority.
+        /// </summary>
+        /// <remarks>
+        /// This behaves the same as <see cref="SubscribeForNotifications(NotificationCallback)"/>, except that the results are recalculated after each
+        /// write transaction according to <paramref name="priority"/>. All of the callbacks for a <see cref="RealmResults{T}"/> share one subscription,
+        /// which always uses the highest priority of the callbacks currently registered.
+        /// </remarks>
+        /// <param name="callback">The callback to be invoked with the updated <see cref="RealmResults{T}" />.</param>
+        /// <param name="priority">How urgently the notifications are needed.</param>
+        /// <returns>
+        /// A subscription token. It must be kept alive for as long as you want to receive change notifications.
+        /// To stop receiving notifications, call <see cref="IDisposable.Dispose" />.
+        /// </returns>
+        public IDisposable SubscribeForNotifications(NotificationCallback callback, NotificationPriority priority)
+        {
+            _callbacks.Add(callback);
+            _callbackPriorities.Add(priority);
+
+            if (_callbacks.Count == 1)
             {
+                _notificationPriority = priority;
                 SubscribeForNotifications();
             }
-
-            _callbacks.Add(callback);
+            else
+            {
+                UpdateNotificationPriority();
+            }
 
             return new NotificationToken(this, callback);
         }
 
         internal void RemoveCallback(NotificationCallback callback)
         {
-            _callbacks.Remove(callback);
+            var index = _callbacks.IndexOf(callback);
+            if (index < 0)
+                return;
+
+            _callbacks.RemoveAt(index);
+            _callbackPriorities.RemoveAt(index);
 
             if (_callbacks.Count == 0)
             {
                 UnsubscribeFromNotifications();
             }
+            else
+            {
+                UpdateNotificationPriority();
+            }
+        }
+
+        // The native notifier uses the highest priority of its callbacks, and the priority of a native callback
+        // can't be changed, so when the highest priority of the managed callbacks changes the subscription is replaced.
+        // The new subscription is added before the old one is removed so that the results stay live in between.
+        private void UpdateNotificationPriority()
+        {
+            var priority = _callbackPriorities.Min();  // High has the lowest value
+            if (priority == _notificationPriority)
+                return;
+
+            var oldToken = _notificationToken;
+            _notificationToken = null;
+            _notificationPriority = priority;
+            SubscribeForNotifications();
+            oldToken.Dispose();
+
+            // the callbacks have already been given the initial results, so the new subscription's are not passed on
+            _skipInitialNotification = _receivedInitialNotification;
         }
 
         private void SubscribeForNotifications()
@@ -234,7 +391,7 @@ private void SubscribeForNotifications()
 
             var managedResultsHandle = GCHandle.Alloc(this);
             var token = new NotificationTokenHandle(ResultsHandle);
-            var tokenHandle = NativeResults.add_notification_callback(ResultsHandle, GCHandle.ToIntPtr(managedResultsHandle), RealmResultsNativeHelper.NotificationCallback);;
+            var tokenHandle = NativeResults.add_notification_callback(ResultsHandle, GCHandle.ToIntPtr(managedResultsHandle), RealmResultsNativeHelper.NotificationCallback, _notificationPriority);
 
             RuntimeHelpers.PrepareConstrainedRegions();
             try
@@ -253,19 +410,30 @@ private void UnsubscribeFromNotifications()
 
             _notificationToken.Dispose();
             _notificationToken = null;
+            _receivedInitialNotification = false;
+            _skipInitialNotification = false;
         }
                     
         void RealmResultsNativeHelper.Interface.NotifyCallbacks(NativeResults.CollectionChangeSet? changes, NativeException? exception)
         {
+            if (changes == null && exception == null)
+            {
+                var skip = _skipInitialNotification;
+                _skipInitialNotification = false;
+                _receivedInitialNotification = true;
+                if (skip)
+                    return;
+            }
+
             var managedException = exception?.Convert();
             ChangeSet changeset = null;
             if (changes != null)
             {
                 NativeResults.CollectionChangeSet actualChanges = changes.Value;
                 changeset = new ChangeSet(
-                    insertedIndices: actualChanges.Insertions.AsEnumerable().Select(i => (int)i).ToArray(),
-                    modifiedIndices: actualChanges.Modifications.AsEnumerable().Select(i => (int)i).ToArray(),
-                    deletedIndices: actualChanges.Deletions.AsEnumerable().Select(i => (int)i).ToArray()
+                    insertedRanges: actualChanges.Insertions.ToRanges(),
+                    modifiedRanges: actualChanges.Modifications.ToRanges(),
+                    deletedRanges: actualChanges.Deletions.ToRanges()
                 );
             }
 
@@ -292,5 +460,32 @@ internal static void NotificationCallback(IntPtr managedResultsHandle, PtrTo<Nat
             var results = (Interface)GCHandle.FromIntPtr(managedResultsHandle).Target;
             results.NotifyCallbacks(changes.Value, exception.Value);
         }
+
+        #if __IOS__
+        [ObjCRuntime.MonoPInvokeCallback(typeof(NativeCommon.NotifyResultsBatchCallback))]
+        #endif
+        internal static void BatchNotificationCallback(IntPtr realmHandle, IntPtr notificationsPtr, IntPtr count)
+        {
+            var notificationSize = Marshal.SizeOf<NativeResults.Notification>();
+            var notifications = new NativeResults.Notification[(int)count];
+            var targets = new Interface[(int)count];
+
+            // Resolve every handle before calling any callbacks, as a callback may unsubscribe another
+            // RealmResults in the batch and so free its handle
+            for (var i = 0; i < notifications.Length; i++)
+            {
+                notifications[i] = Marshal.PtrToStructure<NativeResults.Notification>(IntPtr.Add(notificationsPtr, i * notificationSize));
+                targets[i] = (Interface)GCHandle.FromIntPtr(notifications[i].ManagedResultsHandle).Target;
+            }
+
+            for (var i = 0; i < notifications.Length; i++)
+            {
+                var changes = notifications[i].Changes == IntPtr.Zero ? (NativeResults.CollectionChangeSet?)null
+                    : Marshal.PtrToStructure<NativeResults.CollectionChangeSet>(notifications[i].Changes);
+                var exception = notifications[i].Exception == IntPtr.Zero ? (NativeException?)null
+                    : Marshal.PtrToStructure<NativeException>(notifications[i].Exception);
+                targets[i].NotifyCallbacks(changes, exception);
+            }
+        }
     }
 }
\ No newline at end of file
@@ -63,7 +63,15 @@ public bool MoveNext()
                 return false;
             
             ++_index;
-            var rowPtr = NativeResults.get_row(_enumeratingResults, (IntPtr)_index);
+            IntPtr rowPtr;
+            // running off the end is how enumeration finishes, so it's reported as a status rather than an exception
+            var status = NativeResults.try_get_row(_enumeratingResults, (IntPtr)_index, out rowPtr);
+            NativeCommon.ThrowIfError(status);
+            if (status != NativeStatus.Ok)
+            {
+                Current = null;
+                return false;
+            }
             var rowHandle = Realm.CreateRowHandle(rowPtr, _realm.SharedRealmHandle);
             object nextObj = null;
             if (!rowHandle.IsInvalid)                 
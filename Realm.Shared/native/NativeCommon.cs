@@ -81,6 +81,18 @@ unsafe internal Exception Convert()
         }
     }
 
+    /// <summary>
+    /// Returned by the try_ functions which report errors through their return value rather than by throwing.
+    /// Must match NativeStatus in error_handling.hpp.
+    /// </summary>
+    internal enum NativeStatus : int
+    {
+        Ok = 0,
+        NotFound = 1,
+        IndexOutOfRange = 2,
+        Error = 3
+    }
+
     internal static class NativeCommon
     {
         // declare the type for the MonoPInvokeCallback
@@ -88,6 +100,8 @@ internal static class NativeCommon
 
         public delegate void NotifyRealmCallback (IntPtr realmHandle);
 
+        public delegate void NotifyResultsBatchCallback (IntPtr realmHandle, IntPtr notifications, IntPtr count);
+
         #if DEBUG
         public delegate void DebugLoggerCallback (IntPtr utf8String, IntPtr stringLen);
         #endif
@@ -122,6 +136,24 @@ unsafe private static void DebugLogger(IntPtr utf8String, IntPtr stringLen)
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "register_notify_realm_changed", CallingConvention = CallingConvention.Cdecl)]
         internal static extern void register_notify_realm_changed(NotifyRealmCallback callback);
 
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "register_notify_results_batch", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void register_notify_results_batch(NotifyResultsBatchCallback callback);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "get_last_error", CallingConvention = CallingConvention.Cdecl)]
+        private static extern IntPtr get_last_error(out NativeException exception);
+
+        // throws the exception behind a NativeStatus.Error, other status codes are left for the caller to handle
+        public static void ThrowIfError(NativeStatus status)
+        {
+            if (status != NativeStatus.Error)
+                return;
+
+            NativeException exception;
+            if (get_last_error(out exception) == IntPtr.Zero)
+                throw new RealmException("Native call failed without reporting an error");
+            throw exception.Convert();
+        }
+
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "fake_a_native_exception", CallingConvention = CallingConvention.Cdecl)]
         internal static extern void fake_a_native_exception(IntPtr errorCode);
 
@@ -39,10 +39,18 @@ internal static class NativeLinkList
             CallingConvention = CallingConvention.Cdecl)]
         public static extern void clear(LinkListHandle linklistHandle);
 
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "linklist_get_row_index",
+            CallingConvention = CallingConvention.Cdecl)]
+        public static extern IntPtr get_row_index(LinkListHandle linklistHandle, IntPtr link_ndx);
+
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "linklist_get",
             CallingConvention = CallingConvention.Cdecl)]
         public static extern IntPtr get(LinkListHandle linklistHandle, IntPtr link_ndx);
 
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "linklist_try_get",
+            CallingConvention = CallingConvention.Cdecl)]
+        public static extern NativeStatus try_get(LinkListHandle linklistHandle, IntPtr link_ndx, out IntPtr row);
+
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "linklist_find",
             CallingConvention = CallingConvention.Cdecl)]
         public static extern IntPtr find(LinkListHandle linklistHandle, IntPtr link_ndx, IntPtr start_from);
@@ -131,6 +131,9 @@ internal static class NativeQuery
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "query_find", CallingConvention = CallingConvention.Cdecl)]
         internal static extern IntPtr findDirect(QueryHandle queryHandle, IntPtr beginAtRow);
 
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "query_find_row_index", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr find_row_index(QueryHandle queryHandle, IntPtr beginAtRow);
+
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "query_get_column_index", CallingConvention = CallingConvention.Cdecl)]
         internal static extern IntPtr get_column_index(QueryHandle queryPtr,
         [MarshalAs(UnmanagedType.LPWStr)] String columnName, IntPtr columnNameLen);
@@ -153,6 +156,35 @@ internal static class NativeQuery
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "query_count", CallingConvention = CallingConvention.Cdecl)]
         internal static extern IntPtr count(QueryHandle QueryHandle);
 
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct QueryArgument
+        {
+            public static readonly IntPtr NullArgumentType = (IntPtr)(-1);
+
+            public IntPtr Type;
+            public Int64 IntValue;
+            public double DoubleValue;
+            public IntPtr StringValue;
+            public IntPtr StringLength;
+        }
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "prepared_query_create", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr prepared_query_create([MarshalAs(UnmanagedType.LPWStr)] string objectType, IntPtr objectTypeLen,
+            [MarshalAs(UnmanagedType.LPWStr)] string predicate, IntPtr predicateLen);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "prepared_query_destroy", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void prepared_query_destroy(IntPtr preparedQuery);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "prepared_query_execute", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr prepared_query_execute(IntPtr preparedQuery, SharedRealmHandle sharedRealm,
+            [In] QueryArgument[] arguments, IntPtr argumentCount);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "query_create_from_string", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr create_from_string(SharedRealmHandle sharedRealm,
+            [MarshalAs(UnmanagedType.LPWStr)] string objectType, IntPtr objectTypeLen,
+            [MarshalAs(UnmanagedType.LPWStr)] string predicate, IntPtr predicateLen,
+            [In] QueryArgument[] arguments, IntPtr argumentCount);
+
         public static double average(QueryHandle QueryHandle, long columnIndex)
         {
             throw new NotImplementedException();
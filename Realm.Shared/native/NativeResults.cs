@@ -39,24 +39,165 @@ internal static class NativeResults
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_create_for_query_sorted", CallingConvention = CallingConvention.Cdecl)]
         internal static extern IntPtr create_for_query_sorted(SharedRealmHandle sharedRealm, QueryHandle queryPtr, IntPtr objectSchema, SortOrderHandle sortOrderHandle);
 
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_create_limited", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr create_limited(ResultsHandle results, IntPtr maxCount);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_create_window", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr create_window(ResultsHandle results, IntPtr offset, IntPtr length);
+
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_destroy", CallingConvention = CallingConvention.Cdecl)]
         public static extern void destroy(IntPtr resultsHandle);
 
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_get_row", CallingConvention = CallingConvention.Cdecl)]
         internal static extern IntPtr get_row(ResultsHandle results, IntPtr index);
 
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_try_get_row", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern NativeStatus try_get_row(ResultsHandle results, IntPtr index, out IntPtr row);
+
         [DllImport (InteropConfig.DLL_NAME, EntryPoint = "results_count", CallingConvention = CallingConvention.Cdecl)]
         internal static extern IntPtr count(ResultsHandle results);
 
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_get_row_indices", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr get_row_indices(ResultsHandle results, IntPtr beginIndex, IntPtr count,
+            [Out] IntPtr[] rowIndices, out UInt64 tableVersion);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_get_column_range_bool", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr get_column_range_bool(ResultsHandle results, IntPtr columnIndex, IntPtr beginIndex, IntPtr count,
+            [Out] byte[] values, [Out] byte[] nulls);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_get_column_range_int64", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr get_column_range_int64(ResultsHandle results, IntPtr columnIndex, IntPtr beginIndex, IntPtr count,
+            [Out] long[] values, [Out] byte[] nulls);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_get_column_range_float", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr get_column_range_float(ResultsHandle results, IntPtr columnIndex, IntPtr beginIndex, IntPtr count,
+            [Out] float[] values, [Out] byte[] nulls);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_get_column_range_double", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr get_column_range_double(ResultsHandle results, IntPtr columnIndex, IntPtr beginIndex, IntPtr count,
+            [Out] double[] values, [Out] byte[] nulls);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_get_column_range_datetime_seconds", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr get_column_range_datetime_seconds(ResultsHandle results, IntPtr columnIndex, IntPtr beginIndex, IntPtr count,
+            [Out] long[] values, [Out] byte[] nulls);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_set_parallel_evaluation", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void set_parallel_evaluation(ResultsHandle results, IntPtr parallel);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_find_all_row_indices_parallel", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr find_all_row_indices_parallel(ResultsHandle results, [Out] IntPtr[] rowIndices, IntPtr bufsize,
+            out UInt64 tableVersion);
+
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_clear", CallingConvention = CallingConvention.Cdecl)]
         internal static extern void clear(ResultsHandle results);
 
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_aggregate_many", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void aggregate_many(ResultsHandle results, [In] AggregateRequest[] requests, IntPtr count,
+            [Out] AggregateResult[] aggregates);
+
+        // Mirrors Results::AggregateOp
+        internal enum AggregateOp
+        {
+            Count,
+            Min,
+            Max,
+            Sum,
+            Average
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct AggregateRequest
+        {
+            public IntPtr Column;
+            public IntPtr Op;
+
+            public AggregateRequest(int column, AggregateOp op)
+            {
+                Column = (IntPtr)column;
+                Op = (IntPtr)op;
+            }
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct AggregateResult
+        {
+            public long IntValue;
+            public double DoubleValue;
+            public int Type;
+            public int HasValue;
+
+            public bool IsNull { get { return HasValue == 0; } }
+
+            // the value as the managed type of the aggregate, or null if it has none
+            public object ToObject()
+            {
+                if (IsNull)
+                    return null;
+
+                // values correspond to core/data_type.hpp enum DataType
+                switch (Type)
+                {
+                    case 0:  // type_Int
+                        return IntValue;
+                    case 7:  // type_DateTime
+                        return DateTimeOffsetExtensions.FromUnixTimeSeconds(IntValue);
+                    case 9:  // type_Float
+                        return (float)DoubleValue;
+                    default: // type_Double
+                        return DoubleValue;
+                }
+            }
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct IndexRange
+        {
+            public IntPtr Begin;
+            public IntPtr End;
+        }
+
+        /// <summary>
+        /// An index set as the sorted [Begin, End) ranges it is stored as natively, split into chunks.
+        /// Only valid for the duration of the notification callback.
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        internal unsafe struct IndexSet
+        {
+            [StructLayout(LayoutKind.Sequential)]
+            struct Chunk
+            {
+                public IndexRange* Ranges;
+                public IntPtr Count;
+            }
+
+            Chunk* chunks;
+            IntPtr chunkCount;
+            public IntPtr IndexCount;
+
+            // copies out the ranges, which unlike the individual indices are cheap to copy even for large changes
+            internal IndexRange[] ToRanges()
+            {
+                var rangeCount = 0;
+                for (var i = 0; i < (int)chunkCount; i++)
+                    rangeCount += (int)chunks[i].Count;
+
+                var ranges = new IndexRange[rangeCount];
+                var pos = 0;
+                for (var i = 0; i < (int)chunkCount; i++)
+                {
+                    for (var j = 0; j < (int)chunks[i].Count; j++)
+                        ranges[pos++] = chunks[i].Ranges[j];
+                }
+                return ranges;
+            }
+        }
+
         [StructLayout(LayoutKind.Sequential)]
         internal struct CollectionChangeSet
         {
-            public MarshalledVector<IntPtr> Deletions;
-            public MarshalledVector<IntPtr> Insertions;
-            public MarshalledVector<IntPtr> Modifications;
+            public IndexSet Deletions;
+            public IndexSet Insertions;
+            public IndexSet Modifications;
 
             [StructLayout(LayoutKind.Sequential)]
             public struct Move
@@ -67,12 +208,33 @@ public struct Move
             public MarshalledVector<Move> Moves;
         }
 
+        /// <summary>
+        /// One entry in a batch of notifications, see <see cref="NativeCommon.NotifyResultsBatchCallback"/>.
+        /// Changes and Exception point to a <see cref="CollectionChangeSet"/> and a <see cref="NativeException"/>, or are null.
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct Notification
+        {
+            public IntPtr ManagedResultsHandle;
+            public IntPtr Changes;
+            public IntPtr Exception;
+        }
+
         internal delegate void NotificationCallback(IntPtr managedResultsHandle, PtrTo<CollectionChangeSet> collectionChanges, PtrTo<NativeException> notficiationException);
 
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_add_notification_callback", CallingConvention = CallingConvention.Cdecl)]
-        internal static extern IntPtr add_notification_callback(ResultsHandle results, IntPtr managedResultsHandle, NotificationCallback callback);
+        internal static extern IntPtr add_notification_callback(ResultsHandle results, IntPtr managedResultsHandle, NotificationCallback callback, NotificationPriority priority);
 
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_destroy_notificationtoken", CallingConvention = CallingConvention.Cdecl)]
         internal static extern IntPtr destroy_notificationtoken(IntPtr token);
+
+        // aggregates points to five AggregateResults, indexed by AggregateOp, or is null if exception is set
+        internal delegate void AggregateCallback(IntPtr managedHandle, IntPtr aggregates, PtrTo<NativeException> exception);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_add_aggregate_callback", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr add_aggregate_callback(ResultsHandle results, IntPtr column, IntPtr managedHandle, AggregateCallback callback);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_destroy_aggregate_callback", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr destroy_aggregate_callback(IntPtr context);
     }
 }
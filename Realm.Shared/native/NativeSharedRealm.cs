@@ -30,6 +30,9 @@ internal static class NativeSharedRealm
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "shared_realm_bind_to_managed_realm_handle", CallingConvention = CallingConvention.Cdecl)]
         internal static extern void bind_to_managed_realm_handle(SharedRealmHandle sharedRealm, IntPtr managedRealmHandle);
 
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "shared_realm_set_batch_notifications", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void set_batch_notifications(SharedRealmHandle sharedRealm, IntPtr batch);
+
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "shared_realm_destroy", CallingConvention = CallingConvention.Cdecl)]
         internal static extern void destroy(IntPtr sharedRealm);
 
@@ -68,5 +71,23 @@ internal static class NativeSharedRealm
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "shared_realm_get_schema_version",
             CallingConvention = CallingConvention.Cdecl)]
         internal static extern UInt64 get_schema_version(SharedRealmHandle sharedRealm);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "shared_realm_get_column_map",
+            CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr get_column_map(SharedRealmHandle sharedRealm, [MarshalAs(UnmanagedType.LPWStr)]string objectType, IntPtr objectTypeLength,
+            [MarshalAs(UnmanagedType.LPWStr)]string propertyNames, IntPtr[] propertyNameLengths, IntPtr propertyCount,
+            [Out] IntPtr[] columnIndices, out UInt64 schemaVersion);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "shared_realm_is_column_map_current",
+            CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr is_column_map_current(SharedRealmHandle sharedRealm, UInt64 schemaVersion);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "shared_realm_get_thread_notification_fd",
+            CallingConvention = CallingConvention.Cdecl)]
+        internal static extern Int32 get_thread_notification_fd();
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "shared_realm_drain_thread_notifications",
+            CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr drain_thread_notifications();
     }
 }
@@ -39,6 +39,26 @@ internal static class NativeTable
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "table_get_nullable_datetime_seconds", CallingConvention = CallingConvention.Cdecl)]
         internal static extern IntPtr get_nullable_datetime_seconds(TableHandle handle, IntPtr columnIndex, IntPtr rowIndex, ref long retVal);
 
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "table_get_column_range_bool", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr get_column_range_bool(TableHandle handle, IntPtr columnIndex, IntPtr beginRowIndex, IntPtr count,
+            [Out] byte[] values, [Out] byte[] nulls);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "table_get_column_range_int64", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr get_column_range_int64(TableHandle handle, IntPtr columnIndex, IntPtr beginRowIndex, IntPtr count,
+            [Out] long[] values, [Out] byte[] nulls);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "table_get_column_range_float", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr get_column_range_float(TableHandle handle, IntPtr columnIndex, IntPtr beginRowIndex, IntPtr count,
+            [Out] float[] values, [Out] byte[] nulls);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "table_get_column_range_double", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr get_column_range_double(TableHandle handle, IntPtr columnIndex, IntPtr beginRowIndex, IntPtr count,
+            [Out] double[] values, [Out] byte[] nulls);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "table_get_column_range_datetime_seconds", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr get_column_range_datetime_seconds(TableHandle handle, IntPtr columnIndex, IntPtr beginRowIndex, IntPtr count,
+            [Out] long[] values, [Out] byte[] nulls);
+
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "table_set_string", CallingConvention = CallingConvention.Cdecl)]
         internal static extern void set_string(TableHandle tablePtr, IntPtr columnNdx, IntPtr rowNdx,
             [MarshalAs(UnmanagedType.LPWStr)] string value, IntPtr valueLen);
@@ -51,15 +71,49 @@ internal static class NativeTable
         internal static extern IntPtr get_string(TableHandle handle, IntPtr columnIndex, IntPtr rowIndex,
             IntPtr buffer, IntPtr bufsize, [MarshalAs(UnmanagedType.I1)] out bool isNull);
 
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "table_get_string_ptr", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr get_string_ptr(TableHandle handle, IntPtr columnIndex, IntPtr rowIndex,
+            out IntPtr value, [MarshalAs(UnmanagedType.I1)] out bool isNull);
+
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "table_set_link", CallingConvention = CallingConvention.Cdecl)]
         internal static extern void set_link(TableHandle tablePtr, IntPtr columnNdx, IntPtr rowNdx, IntPtr targetRowNdx);
 
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "table_clear_link", CallingConvention = CallingConvention.Cdecl)]
         internal static extern void clear_link(TableHandle tablePtr, IntPtr columnNdx, IntPtr rowNdx);
 
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct BulkInsertColumn
+        {
+            public IntPtr ColumnIndex;
+            public IntPtr Values;
+            public IntPtr StringOffsets;
+            public IntPtr StringLengths;
+            public IntPtr Nulls;
+        }
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "table_bulk_insert", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr bulk_insert(TableHandle tableHandle, IntPtr rowCount,
+            [In] BulkInsertColumn[] columns, IntPtr columnCount);
+
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "table_get_link", CallingConvention = CallingConvention.Cdecl)]
         internal static extern IntPtr get_link(TableHandle handle, IntPtr columnIndex, IntPtr rowIndex);
 
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "table_try_get_link", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern NativeStatus try_get_link(TableHandle handle, IntPtr columnIndex, IntPtr rowIndex, out IntPtr row);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "table_get_link_row_index", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr get_link_row_index(TableHandle handle, IntPtr columnIndex, IntPtr rowIndex);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "table_get_version", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern UInt64 get_version(TableHandle handle);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "table_is_valid_row_reference", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr is_valid_row_reference(TableHandle handle, IntPtr rowIndex, UInt64 version);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "table_are_valid_row_references", CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void are_valid_row_references(TableHandle handle, IntPtr[] rowIndices, IntPtr count, UInt64 version,
+            [Out] byte[] valid);
+
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "table_get_linklist", CallingConvention = CallingConvention.Cdecl)]
         internal static extern IntPtr get_linklist(TableHandle handle, IntPtr columnIndex, IntPtr rowIndex);
 
@@ -78,6 +78,76 @@ public void ResultsShouldSendNotifications()
                 Assert.That(changes?.InsertedIndices, Is.EquivalentTo(new int[] { 0 }));
             }
         }
+
+        [Test]
+        public void ResultsShouldSendChangesAsRanges()
+        {
+            _realm.Write(() =>
+            {
+                for (var i = 0; i < 5; i++)
+                    _realm.CreateObject<Person>().FirstName = i.ToString();
+            });
+
+            var query = _realm.All<Person>();
+            RealmResults<Person>.ChangeSet changes = null;
+            RealmResults<Person>.NotificationCallback cb = (s, c, e) => changes = c;
+
+            using (query.SubscribeForNotifications(cb))
+            {
+                TestHelpers.RunEventLoop(TimeSpan.FromMilliseconds(100));
+
+                _realm.Write(() =>
+                {
+                    _realm.CreateObject<Person>();
+                    _realm.CreateObject<Person>();
+                    query.First(p => p.FirstName == "1").LastName = "Modified";
+                    query.First(p => p.FirstName == "3").LastName = "Modified";
+                });
+
+                TestHelpers.RunEventLoop(TimeSpan.FromMilliseconds(100));
+                Assert.That(changes, Is.Not.Null);
+                Assert.That(changes.InsertedRanges.Select(r => Tuple.Create(r.Begin, r.End)), Is.EqualTo(new[] { Tuple.Create(5, 7) }));
+                Assert.That(changes.ModifiedRanges.Select(r => Tuple.Create(r.Begin, r.End)), Is.EqualTo(new[] { Tuple.Create(1, 2), Tuple.Create(3, 4) }));
+                Assert.That(changes.DeletedRanges, Is.Empty);
+
+                Assert.That(changes.InsertedIndices, Is.EqualTo(new[] { 5, 6 }));
+                Assert.That(changes.ModifiedIndices, Is.EqualTo(new[] { 1, 3 }));
+                Assert.That(changes.DeletedIndices, Is.Empty);
+            }
+        }
+
+        [Test]
+        public void ResultsShouldSendLargeDeletionsAsOneRange()
+        {
+            const int count = 100000;
+            _realm.Write(() =>
+            {
+                for (var i = 0; i < count; i++)
+                    _realm.CreateObject<Person>();
+            });
+
+            var query = _realm.All<Person>();
+            RealmResults<Person>.ChangeSet changes = null;
+            RealmResults<Person>.NotificationCallback cb = (s, c, e) => changes = c;
+
+            using (query.SubscribeForNotifications(cb))
+            {
+                TestHelpers.RunEventLoop(TimeSpan.FromMilliseconds(100));
+
+                _realm.Write(() => _realm.RemoveAll<Person>());
+
+                TestHelpers.RunEventLoop(TimeSpan.FromMilliseconds(100));
+                Assert.That(changes, Is.Not.Null);
+                Assert.That(changes.DeletedRanges.Length, Is.EqualTo(1));
+                Assert.That(changes.DeletedRanges[0].Begin, Is.EqualTo(0));
+                Assert.That(changes.DeletedRanges[0].End, Is.EqualTo(count));
+                Assert.That(changes.InsertedRanges, Is.Empty);
+
+                // only expanded when asked for, and then the same array every time
+                Assert.That(changes.DeletedIndices.Length, Is.EqualTo(count));
+                Assert.That(changes.DeletedIndices, Is.SameAs(changes.DeletedIndices));
+            }
+        }
     }
 }
 
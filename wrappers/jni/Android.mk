@@ -20,17 +20,22 @@ LOCAL_CFLAGS :=
 LOCAL_SRC_FILES := src/object-store/src/collection_notifications.cpp
 LOCAL_SRC_FILES += src/object-store/src/index_set.cpp
 LOCAL_SRC_FILES += src/object-store/src/list.cpp
+LOCAL_SRC_FILES += src/object-store/src/live_aggregate.cpp
 LOCAL_SRC_FILES += src/object-store/src/object_schema.cpp
 LOCAL_SRC_FILES += src/object-store/src/object_store.cpp
 LOCAL_SRC_FILES += src/object-store/src/results.cpp
 LOCAL_SRC_FILES += src/object-store/src/schema.cpp
 LOCAL_SRC_FILES += src/object-store/src/shared_realm.cpp
-#LOCAL_SRC_FILES += src/object-store/src/parser/parser.cpp
-#LOCAL_SRC_FILES += src/object-store/src/parser/query_builder.cpp
+LOCAL_SRC_FILES += src/object-store/src/parser/parser.cpp
+LOCAL_SRC_FILES += src/object-store/src/parser/query_builder.cpp
 LOCAL_SRC_FILES += src/object-store/src/impl/realm_coordinator.cpp
+LOCAL_SRC_FILES += src/object-store/src/impl/aggregate_notifier.cpp
 LOCAL_SRC_FILES += src/object-store/src/impl/collection_change_builder.cpp
 LOCAL_SRC_FILES += src/object-store/src/impl/collection_notifier.cpp
+LOCAL_SRC_FILES += src/object-store/src/impl/limited_query.cpp
 LOCAL_SRC_FILES += src/object-store/src/impl/list_notifier.cpp
+LOCAL_SRC_FILES += src/object-store/src/impl/notifier_pool.cpp
+LOCAL_SRC_FILES += src/object-store/src/impl/parallel_query_executor.cpp
 LOCAL_SRC_FILES += src/object-store/src/impl/results_notifier.cpp
 LOCAL_SRC_FILES += src/object-store/src/impl/transact_log_handler.cpp
 LOCAL_SRC_FILES += src/object-store/src/impl/android/external_commit_helper.cpp
@@ -57,6 +62,7 @@ LOCAL_CPPFLAGS := -DHAVE_PTHREADS
 LOCAL_CPPFLAGS += -DREALM_HAVE_CONFIG=1
 LOCAL_C_INCLUDES += core-android/include
 LOCAL_C_INCLUDES += src/object-store/src/
+LOCAL_C_INCLUDES += src/object-store/external/pegtl
 
 ifdef NDK_DEBUG
 LOCAL_STATIC_LIBRARIES := realm-android-dbg
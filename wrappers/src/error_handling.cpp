@@ -24,6 +24,7 @@
 #include "realm_export_decls.hpp"
 #include "error_handling.hpp"
 #include "realm_error_type.hpp"
+#include "thread_local_slot.hpp"
 
 // core headers for exception types
 #include "realm/util/file.hpp" 
@@ -34,8 +35,22 @@ using ManagedExceptionThrowerT = void(*)(realm::NativeException::Marshallable);
 // CALLBACK TO THROW IN MANAGED SPACE
 static ManagedExceptionThrowerT ManagedExceptionThrower = nullptr;
 
+namespace {
+
+    realm::NativeException* last_error_for_current_thread(bool create)
+    {
+        return realm::binding::thread_local_instance<realm::NativeException>(create);
+    }
+
+}   // anonymous namespace
+
 namespace realm {
 
+    void set_last_error(NativeException exception)
+    {
+        *last_error_for_current_thread(true) = std::move(exception);
+    }
+
     void throw_managed_exception(const NativeException& exception)
     {
         assert(ManagedExceptionThrower != nullptr);
@@ -114,6 +129,17 @@ REALM_EXPORT void set_exception_thrower(ManagedExceptionThrowerT userThrower)
     ManagedExceptionThrower = userThrower;
 }
 
+// Fetch the details of the last NativeStatus::Error returned to this thread. The message stays valid until the
+// next error on this thread. Returns false if there has been no error on this thread.
+REALM_EXPORT size_t get_last_error(realm::NativeException::Marshallable& error)
+{
+    auto last_error = last_error_for_current_thread(false);
+    if (!last_error)
+        return 0;
+    error = last_error->for_marshalling();
+    return 1;
+}
+
 // allow C# test code to generate an exception being thrown back
 REALM_EXPORT void fake_a_native_exception(int errorType)
 {
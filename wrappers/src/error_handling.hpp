@@ -74,6 +74,34 @@ auto handle_errors(F&& func) -> decltype(func())
     }
 }
 
+/**
+Status codes returned by exports which use handle_errors_status() rather than handle_errors().
+Expected conditions have codes of their own, so reporting them never involves an exception, and
+for actual errors the details are left in a per-thread slot which managed code only reads, with
+get_last_error(), when it sees NativeStatus::Error.
+@warning if you update these codes also update the matching NativeStatus in NativeCommon.cs
+*/
+enum class NativeStatus : int32_t {
+    Ok = 0,
+    NotFound = 1,
+    IndexOutOfRange = 2,
+    Error = 3
+};
+
+void set_last_error(NativeException exception);
+
+template <class F>
+NativeStatus handle_errors_status(F&& func) noexcept
+{
+    try {
+        return func();
+    }
+    catch (...) {
+        set_last_error(convert_exception());
+        return NativeStatus::Error;
+    }
+}
+
 } // namespace realm
 
 #endif // ERROR_HANDLING_HPP
\ No newline at end of file
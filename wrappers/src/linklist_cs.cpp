@@ -45,6 +45,17 @@ REALM_EXPORT void linklist_insert(SharedLinkViewRef* linklist_ptr, size_t link_n
   });
 }
 
+// Handle-free alternative to linklist_get: returns the row index in the target table
+REALM_EXPORT size_t linklist_get_row_index(SharedLinkViewRef* linklist_ptr, size_t link_ndx)
+{
+  return handle_errors([&]() {
+    const size_t count = (**linklist_ptr)->size();
+    if (link_ndx >= count)
+      throw IndexOutOfRangeException("Get from RealmList", link_ndx, count);
+    return (**linklist_ptr)->get(link_ndx).get_index();
+  });
+}
+
 REALM_EXPORT Row* linklist_get(SharedLinkViewRef* linklist_ptr, size_t link_ndx)
 {
   return handle_errors([&]() -> Row* {
@@ -56,6 +67,18 @@ REALM_EXPORT Row* linklist_get(SharedLinkViewRef* linklist_ptr, size_t link_ndx)
   });
 }
 
+// Status code alternative to linklist_get, see NativeStatus in error_handling.hpp
+REALM_EXPORT NativeStatus linklist_try_get(SharedLinkViewRef* linklist_ptr, size_t link_ndx, Row*& row)
+{
+  return handle_errors_status([&]() {
+    row = nullptr;
+    if (link_ndx >= (**linklist_ptr)->size())
+      return NativeStatus::IndexOutOfRange;
+    row = new Row((**linklist_ptr)->get(link_ndx));
+    return NativeStatus::Ok;
+  });
+}
+
 REALM_EXPORT size_t linklist_find(SharedLinkViewRef* linklist_ptr, size_t row_ndx, size_t start_from)
 {
   return handle_errors([&]() {
@@ -20,8 +20,33 @@
 #include <realm.hpp>
 #include <realm/lang_bind_helper.hpp>
 #include "error_handling.hpp"
+#include "thread_local_slot.hpp"
+#include <cstring>
 
 using namespace realm;
+using namespace realm::binding;
+
+namespace {
+
+//kept as a plain loop with no dependencies between iterations so that the compiler vectorizes it
+void widen_ascii(const char* begin, const char* end, uint16_t* out)
+{
+    for (; begin != end; ++begin, ++out)
+        *out = static_cast<unsigned char>(*begin);
+}
+
+//FNV-1a
+size_t hash_bytes(const char* begin, const char* end)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (; begin != end; ++begin) {
+        hash ^= static_cast<unsigned char>(*begin);
+        hash *= 1099511628211ULL;
+    }
+    return size_t(hash);
+}
+
+} // anonymous namespace
 
 //stringdata is utf8
 //cshapbuffer is a c# stringbuilder buffer marshalled as utf16 bufsize is the size of the csharp buffer measured in 16 bit words. The buffer is in fact one char larger than that, to make room for a terminating null character
@@ -46,34 +71,76 @@ size_t realm::binding::stringdata_to_csharpstringbuffer(StringData str, uint16_t
     if (str.size() <= 0) {
         return 0;
     }
+
+    //fast path. ASCII transcodes to one 16 bit character per byte, and we already know it fits
     const char* in_begin = str.data();
     const char* in_end = str.data() + str.size();
+    if (is_ascii(in_begin, in_end)) {
+        widen_ascii(in_begin, in_end, csharpbuffer);
+        return str.size();
+    }
 
-    uint16_t* out_begin = csharpbuffer;
-    uint16_t* out_end = csharpbuffer + bufsize;
-
-    typedef realm::util::Utf8x16<uint16_t, std::char_traits<char16_t>>Xcode;    //This might not work in old compilers (the std::char_traits<char16_t> ). 
-
-    size_t size = Xcode::find_utf16_buf_size(in_begin, in_end);//Figure how much space is actually needed
-
-    if (in_begin != in_end) {
+    auto utf16 = Utf16StringCache::get_for_current_thread().get(str);
+    if (!utf16) {
         std::cerr << "BAD UTF8 DATA IN stringdata_tocsharpbuffer :" << str.data() << "\n";
         return -1;//bad uft8 data    
     }
-    if (size > bufsize)
-        return size; //bufsize is too small. Return needed size
+    if (utf16->size() > bufsize)
+        return utf16->size(); //bufsize is too small. Return needed size. The next attempt will be served from the cache
 
-      //the transcoded string fits in the buffer
+    std::copy(utf16->begin(), utf16->end(), csharpbuffer);
+    return utf16->size();        //transcode complete. return the number of 16-bit characters used in the buffer
+}
 
-    in_begin = str.data();
-    in_end = str.data() + str.size();
+Utf16StringCache& Utf16StringCache::get_for_current_thread()
+{
+    return *thread_local_instance<Utf16StringCache>();
+}
 
-    if (Xcode::to_utf16(in_begin, in_end, out_begin, out_end)) {
-        size_t chars_used = out_begin - csharpbuffer;
-        //csharpbuffer[chars_used-5]=0; //slightly ugly hack. C# looks for a null terminated string in the buffer, so we have to null terminate this string for C# to pick up where the end is
-        return (chars_used);        //transcode complete. return the number of 16-bit characters used in the buffer,excluding the null terminator
+const std::vector<uint16_t>* Utf16StringCache::get(StringData str)
+{
+    const char* begin = str.data();
+    const char* end = str.data() + str.size();
+
+    if (is_ascii(begin, end)) {
+        m_scratch.resize(str.size());
+        widen_ascii(begin, end, m_scratch.data());
+        return &m_scratch;
     }
-    return -1;//bad utf8 data. this cannot happen
-}
 
+    const size_t hash = hash_bytes(begin, end);
+    auto range = m_entries.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        auto& utf8 = it->second.utf8;
+        if (utf8.size() == str.size() && std::equal(begin, end, utf8.begin()))
+            return &it->second.utf16;
+    }
+
+    typedef realm::util::Utf8x16<uint16_t, std::char_traits<char16_t>>Xcode;
+
+    const char* in_begin = begin;
+    size_t size = Xcode::find_utf16_buf_size(in_begin, end);
+    if (in_begin != end)
+        return nullptr;
 
+    std::vector<uint16_t> utf16(size);
+    in_begin = begin;
+    uint16_t* out_begin = utf16.data();
+    if (!Xcode::to_utf16(in_begin, end, out_begin, out_begin + size))
+        return nullptr;
+
+    //when full just start over. Strings are cheap to re-transcode and the hot ones quickly come back
+    const size_t entry_bytes = str.size() + size * sizeof(uint16_t);
+    if (m_cached_bytes + entry_bytes > max_cached_bytes) {
+        m_entries.clear();
+        m_cached_bytes = 0;
+    }
+    if (entry_bytes > max_cached_bytes) {
+        m_scratch = std::move(utf16);
+        return &m_scratch;
+    }
+
+    m_cached_bytes += entry_bytes;
+    auto it = m_entries.emplace(hash, Entry{std::string(begin, str.size()), std::move(utf16)});
+    return &it->second.utf16;
+}
@@ -21,69 +21,140 @@
 
 #include <realm.hpp>
 #include <realm/util/utf8.hpp>
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
 
 namespace realm {
 namespace binding {
 
+//checks eight bytes at a time for any byte with the high bit set
+inline bool is_ascii(const char* begin, const char* end)
+{
+    const uint64_t high_bits = 0x8080808080808080ULL;
+    for (; end - begin >= 8; begin += 8) {
+        uint64_t word;
+        memcpy(&word, begin, sizeof(word));
+        if (word & high_bits)
+            return false;
+    }
+    for (; begin != end; ++begin) {
+        if (static_cast<unsigned char>(*begin) & 0x80)
+            return false;
+    }
+    return true;
+}
+
+//written so that it has no early exit, which lets the compiler vectorize it
+inline bool is_ascii(const uint16_t* begin, const uint16_t* end)
+{
+    uint16_t bits = 0;
+    for (; begin != end; ++begin)
+        bits |= *begin;
+    return bits < 0x80;
+}
+
 class Utf16StringAccessor {
 public:
     Utf16StringAccessor(uint16_t* csbuffer, size_t csbufsize)
     {
-        // For efficiency, if the incoming UTF-16 string is sufficiently
-        // small, we will choose an UTF-8 output buffer whose size (in
-        // bytes) is simply 4 times the number of 16-bit elements in the
-        // input. This is guaranteed to be enough. However, to avoid
-        // excessive over allocation, this is not done for larger input
+        // Most strings passed in are short ASCII names and keys, so those are
+        // narrowed straight into a buffer inside the accessor without
+        // touching the heap or the transcoder. Otherwise, if the incoming
+        // UTF-16 string is sufficiently small, we will choose an UTF-8 output
+        // buffer whose size (in bytes) is simply 3 times the number of 16-bit
+        // elements in the input. This is guaranteed to be enough. However, to
+        // avoid excessive over allocation, this is not done for larger input
         // strings.
 
         error = false;
         typedef realm::util::Utf8x16<uint16_t, std::char_traits<char16_t>>Xcode;    //This might not work in old compilers (the std::char_traits<char16_t> ).     
         size_t max_project_size = 48;
 
-        REALM_ASSERT(max_project_size <= std::numeric_limits<size_t>::max() / 4);
+        REALM_ASSERT(max_project_size <= std::numeric_limits<size_t>::max() / 3);
+
+        const uint16_t* in_begin = csbuffer;
+        const uint16_t* in_end = csbuffer + csbufsize;
+
+        if (is_ascii(in_begin, in_end)) {
+            char* out = allocate(csbufsize);
+            for (size_t i = 0; i < csbufsize; ++i)
+                out[i] = char(csbuffer[i]);
+            m_size = csbufsize;
+            return;
+        }
 
         size_t u8buf_size;
         if (csbufsize <= max_project_size) {
-            u8buf_size = csbufsize * 4;
+            u8buf_size = csbufsize * 3;
         }
         else {
             const uint16_t* begin = csbuffer;
-            const uint16_t* end = csbuffer + csbufsize;
-            u8buf_size = Xcode::find_utf8_buf_size(begin, end);
+            u8buf_size = Xcode::find_utf8_buf_size(begin, in_end);
         }
-        m_data.reset(new char[u8buf_size]);
-        {
-            const uint16_t* in_begin = csbuffer;
-            const uint16_t* in_end = csbuffer + csbufsize;
-            char* out_begin = m_data.get();
-            char* out_end = m_data.get() + u8buf_size;
-            if (!Xcode::to_utf8(in_begin, in_end, out_begin, out_end)) {
-                m_size = 0;
-                error = true;
-                return;//calling method should handle this. We can't throw exceptions
-            }
-            REALM_ASSERT(in_begin == in_end);
-            m_size = out_begin - m_data.get();
+        char* out_begin = allocate(u8buf_size);
+        char* out_end = out_begin + u8buf_size;
+        if (!Xcode::to_utf8(in_begin, in_end, out_begin, out_end)) {
+            m_size = 0;
+            error = true;
+            return;//calling method should handle this. We can't throw exceptions
         }
+        REALM_ASSERT(in_begin == in_end);
+        m_size = out_begin - m_data;
     }
 
+    Utf16StringAccessor(Utf16StringAccessor&& other)
+    : error(other.error)
+    , m_heap_data(std::move(other.m_heap_data))
+    , m_size(other.m_size)
+    {
+        if (m_heap_data) {
+            m_data = m_heap_data.get();
+        }
+        else {
+            std::copy(other.m_small_data, other.m_small_data + m_size, m_small_data);
+            m_data = m_small_data;
+        }
+    }
+
+    Utf16StringAccessor(const Utf16StringAccessor&) = delete;
+    Utf16StringAccessor& operator=(const Utf16StringAccessor&) = delete;
+
     operator realm::StringData() const //ASD has this vanished from core? REALM_NOEXCEPT
     {
-        return realm::StringData(m_data.get(), m_size);
+        return realm::StringData(m_data, m_size);
     }
 
     std::string to_string() const
     {
-        return std::string(m_data.get(), m_size);
+        return std::string(m_data, m_size);
     }
 
-    const char* data() const { return m_data.get();  }
+    const char* data() const { return m_data;  }
     size_t size() const { return m_size;  }
 
     bool error;
 private:
-    std::unique_ptr<char[]> m_data;
+    // strings which transcode to at most this many bytes are stored inside the accessor itself
+    static const size_t small_buffer_size = 128;
+
+    char* allocate(size_t size)
+    {
+        if (size <= small_buffer_size) {
+            m_data = m_small_data;
+        }
+        else {
+            m_heap_data.reset(new char[size]);
+            m_data = m_heap_data.get();
+        }
+        return m_data;
+    }
+
+    std::unique_ptr<char[]> m_heap_data;
+    char* m_data;
     std::size_t m_size;
+    char m_small_data[small_buffer_size];
 };
 
 //as We've got no idea how the compiler represents an instance of DataType on the stack, perhaps it's better to send back a size_t with the value.
@@ -121,7 +192,71 @@ inline SharedGroup::DurabilityLevel size_t_to_durabilitylevel(size_t value) {
     return SharedGroup::durability_MemOnly;
 }
 
-size_t stringdata_to_csharpstringbuffer(StringData str, uint16_t * csharpbuffer, size_t bufsize); //note bufsize is _in_16bit_words 
+size_t stringdata_to_csharpstringbuffer(StringData str, uint16_t * csharpbuffer, size_t bufsize); //note bufsize is _in_16bit_words
+
+//caches the UTF-16 form of recently read non-ASCII strings, so that reading the same strings again and again
+//(or retrying a read with a larger buffer) doesn't transcode them every time. ASCII strings are not cached as
+//widening them is about as cheap as looking them up.
+//there is one cache per thread, as Realms and their accessors are confined to the thread they were opened on.
+class Utf16StringCache {
+public:
+    static Utf16StringCache& get_for_current_thread();
+
+    //returns the UTF-16 form of str, or nullptr if str is not valid UTF-8.
+    //the returned buffer stays valid until the next call to get() on this cache
+    const std::vector<uint16_t>* get(StringData str);
+
+private:
+    static const size_t max_cached_bytes = 4 * 1024 * 1024;
+
+    struct Entry {
+        std::string utf8;
+        std::vector<uint16_t> utf16;
+    };
+    std::unordered_multimap<size_t, Entry> m_entries; //keyed on a hash of the UTF-8 data
+    size_t m_cached_bytes = 0;
+    std::vector<uint16_t> m_scratch; //holds the result for strings which are not cached
+};
+
+//copies one column of count rows into a caller supplied buffer in a single call, rather than one p/invoke per cell.
+//row_at(i) returns the row accessor for the i'th value to copy and get(row) reads the value out of it.
+//if nulls is non-null it receives a bitmap of (count + 7) / 8 bytes where bit i is set if the i'th value is null
+//(or its row has been deleted), in which case values[i] is set to T{}.
+template <typename T, typename RowAt, typename Getter>
+void copy_column_values(size_t column_ndx, bool nullable, size_t count, RowAt&& row_at, Getter&& get, T* values, uint8_t* nulls)
+{
+    if (nulls)
+        std::fill(nulls, nulls + (count + 7) / 8, uint8_t(0));
+
+    for (size_t i = 0; i < count; ++i) {
+        auto row = row_at(i);
+        if (!row.is_attached() || (nullable && row.is_null(column_ndx))) {
+            values[i] = T{};
+            if (nulls)
+                nulls[i / 8] |= uint8_t(1 << (i % 8));
+            continue;
+        }
+        values[i] = get(row);
+    }
+}
+
+//rows can be handed to C# as a (table, row index, table version) triple instead of a heap allocated Row.
+//any write to the table changes its version and so invalidates every reference to it, including those to
+//rows the write didn't touch; a reference is only usable while get_table_version() still returns the
+//version it was handed out with.
+//getting the version builds a Query and a TableView, so it should be done once per batch of rows
+//rather than once per row.
+inline uint64_t get_table_version(Table& table)
+{
+    //an empty TableView is the cheapest way to ask core for the current version of a table
+    return table.where().find_all(0, 0, 0).sync_if_needed();
+}
+
+//current_version is the result of get_table_version(), which the caller gets once for all the rows it checks
+inline bool is_valid_row_reference(Table& table, size_t row_ndx, uint64_t version, uint64_t current_version)
+{
+    return version == current_version && row_ndx < table.size();
+}
 
 } // namespace binding
 } // namespace realm
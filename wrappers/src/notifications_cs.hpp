@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef NOTIFICATIONS_CS_HPP
+#define NOTIFICATIONS_CS_HPP
+
+#include <deque>
+#include <vector>
+#include "error_handling.hpp"
+#include "object-store/src/binding_context.hpp"
+#include "object-store/src/collection_notifications.hpp"
+
+namespace realm {
+namespace binding {
+
+struct MarshallableCollectionChangeSet {
+    // An IndexSet as the sorted [begin, end) ranges it stores rather than as individual indices, so
+    // that large changes such as clearing a table don't have to be expanded. The ranges point straight
+    // into the IndexSet's chunks, and are only valid for the duration of the callback.
+    struct MarshallableIndexSet {
+        struct Chunk {
+            const IndexSet::value_type* ranges;
+            size_t count;
+        };
+
+        const Chunk* chunks;
+        size_t chunk_count;
+        size_t index_count;
+    };
+
+    MarshallableIndexSet deletions;
+    MarshallableIndexSet insertions;
+    MarshallableIndexSet modifications;
+    
+    struct {
+        CollectionChangeSet::Move* moves;
+        size_t count;
+    } moves;
+};
+
+// Owns a CollectionChangeSet along with the MarshallableCollectionChangeSet pointing into it
+class MarshalledCollectionChangeSet {
+public:
+    MarshalledCollectionChangeSet(CollectionChangeSet changes);
+
+    MarshalledCollectionChangeSet(const MarshalledCollectionChangeSet&) = delete;
+    MarshalledCollectionChangeSet& operator=(const MarshalledCollectionChangeSet&) = delete;
+
+    MarshallableCollectionChangeSet* get() { return &m_marshallable; }
+
+private:
+    using Chunk = MarshallableCollectionChangeSet::MarshallableIndexSet::Chunk;
+
+    CollectionChangeSet m_changes;
+    std::vector<Chunk> m_deletions;
+    std::vector<Chunk> m_insertions;
+    std::vector<Chunk> m_modifications;
+    MarshallableCollectionChangeSet m_marshallable;
+};
+
+// One Results' notification in a batch delivered with ManagedBatchNotificationCallback.
+// changes is null if nothing changed (the initial notification), error is null if there was no error.
+struct MarshallableNotification {
+    void* managed_results;
+    MarshallableCollectionChangeSet* changes;
+    NativeException::Marshallable* error;
+};
+
+using ManagedBatchNotificationCallback = void(*)(void* managed_realm_handle, MarshallableNotification* notifications, size_t count);
+
+class CSharpBindingContext: public BindingContext {
+public:
+    CSharpBindingContext(void* managed_realm_handle) : m_managed_realm_handle(managed_realm_handle) {}
+
+    void did_change(std::vector<ObserverState> const&, std::vector<void*> const&) override;
+    void will_send_notifications() override;
+    void did_send_notifications() override;
+
+    void set_managed_realm_handle(void* managed_realm_handle) { m_managed_realm_handle = managed_realm_handle; }
+
+    // In batched mode, the Results notifications which are ready at the same time are gathered up and
+    // handed to managed code with a single call to the ManagedBatchNotificationCallback, rather than
+    // calling into managed code once per Results
+    void set_batch_notifications(bool batch) { m_batch_notifications = batch; }
+
+    // Returns false if the notification isn't part of a batch and should be delivered immediately
+    bool add_to_batch(void* managed_results, CollectionChangeSet& changes, std::exception_ptr error);
+
+private:
+    struct PendingNotification {
+        PendingNotification(void* managed_results, CollectionChangeSet changes)
+        : managed_results(managed_results), changes(std::move(changes)) { }
+
+        void* managed_results;
+        MarshalledCollectionChangeSet changes;
+        bool has_changes = false;
+        bool has_error = false;
+        NativeException error;
+        NativeException::Marshallable marshallable_error;
+    };
+
+    void* m_managed_realm_handle;
+    bool m_batch_notifications = false;
+    bool m_sending_notifications = false;
+    // a deque so that the pending notifications don't move as more are added
+    std::deque<PendingNotification> m_pending;
+};
+
+} // namespace binding
+} // namespace realm
+
+#endif  // NOTIFICATIONS_CS_HPP
@@ -104,6 +104,13 @@ public:
     virtual void did_change(std::vector<ObserverState> const& observers,
                             std::vector<void*> const& invalidated);
 
+    // Called before and after the callbacks for the asynchronous collection
+    // notifications which are ready for this Realm are called. All of the
+    // callbacks called in between are for the same transaction version, which
+    // lets the binding batch them up and deliver them together.
+    virtual void will_send_notifications() { }
+    virtual void did_send_notifications() { }
+
     // Change information for a single field of a row
     struct ColumnInfo {
         // Did this column change?
@@ -22,6 +22,7 @@
 #include "index_set.hpp"
 #include "util/atomic_shared_ptr.hpp"
 
+#include <cstdint>
 #include <exception>
 #include <functional>
 #include <memory>
@@ -66,6 +67,17 @@ struct CollectionChangeSet {
 };
 
 using CollectionChangeCallback = std::function<void (CollectionChangeSet, std::exception_ptr)>;
+
+// How urgently a collection's notifications are needed. After each commit the
+// notifiers with High priority are run and delivered first, then the Normal
+// ones, and the Background ones are only run once all of the others have been
+// delivered. A notifier with several callbacks uses the highest priority of
+// any of them.
+enum class NotificationPriority : uint8_t {
+    High,
+    Normal,
+    Background
+};
 } // namespace realm
 
 #endif // REALM_COLLECTION_NOTIFICATIONS_HPP
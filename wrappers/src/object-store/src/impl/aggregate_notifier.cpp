@@ -0,0 +1,514 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "impl/aggregate_notifier.hpp"
+
+#include "impl/limited_query.hpp"
+#include "shared_realm.hpp"
+
+#include <algorithm>
+
+using namespace realm;
+using namespace realm::_impl;
+
+namespace realm {
+namespace _impl {
+// The running count, sum, min and max of a column. If rows are tracked, the
+// value of each row of the table which is included is also kept, so that the
+// totals can be updated from the changed rows, including deleted ones.
+class AggregateState {
+public:
+    virtual ~AggregateState() = default;
+
+    // Recompute the totals from rows [begin, end) of tv
+    virtual void reset(Table const& table, TableView const& tv, size_t begin, size_t end, bool track_rows) = 0;
+
+    // Update the totals for the rows which were deleted, moved, inserted or
+    // modified by changes, where matches(row) checks if a row matches the
+    // query. Returns false without changing anything if the changes can't be
+    // applied to the tracked rows.
+    virtual bool update(Table const& table, CollectionChangeBuilder const& changes,
+                        std::function<bool (size_t)> const& matches) = 0;
+
+    virtual LiveAggregate::Values get() const = 0;
+};
+} // namespace _impl
+} // namespace realm
+
+namespace {
+// Updating the totals evaluates the query separately for each inserted or
+// modified row, which is much slower per row than running it over the whole
+// table, so it's only done when at most 1/this of the table changed
+const size_t min_rows_per_changed_row = 16;
+
+// Check if every row which wasn't deleted or moved by changes is still at the
+// same index, i.e. that no rows were inserted anywhere but the end of the
+// table or a slot freed by move_last_over()
+bool rows_kept_in_place(CollectionChangeBuilder const& changes, size_t old_size, size_t new_size)
+{
+    const size_t common = std::min(old_size, new_size);
+    if (changes.deletions.count(common, old_size) != old_size - common)
+        return false;
+    if (changes.insertions.count(common, new_size) != new_size - common)
+        return false;
+    if (changes.deletions.count(0, common) != changes.insertions.count(0, common))
+        return false;
+    for (auto range : changes.deletions) {
+        if (range.first >= common)
+            break;
+        for (size_t i = range.first, end = std::min(range.second, common); i < end; ++i) {
+            if (!changes.insertions.contains(i))
+                return false;
+        }
+    }
+    return true;
+}
+
+template<typename T>
+T get_value(Table const& table, size_t column, DataType type, size_t row);
+
+template<>
+int64_t get_value<int64_t>(Table const& table, size_t column, DataType type, size_t row)
+{
+    if (type == type_DateTime)
+        return table.get_datetime(column, row).get_datetime();
+    return table.get_int(column, row);
+}
+
+template<>
+float get_value<float>(Table const& table, size_t column, DataType, size_t row)
+{
+    return table.get_float(column, row);
+}
+
+template<>
+double get_value<double>(Table const& table, size_t column, DataType, size_t row)
+{
+    return table.get_double(column, row);
+}
+
+Mixed to_mixed(int64_t value, DataType type)
+{
+    if (type == type_DateTime)
+        return Mixed(DateTime(time_t(value)));
+    return Mixed(value);
+}
+
+Mixed to_mixed(float value, DataType) { return Mixed(value); }
+Mixed to_mixed(double value, DataType) { return Mixed(value); }
+
+template<typename T, typename Sum>
+class TypedAggregateState : public AggregateState {
+public:
+    TypedAggregateState(size_t column, DataType type) : m_column(column), m_type(type) { }
+
+    void reset(Table const& table, TableView const& tv, size_t begin, size_t end, bool track_rows) override
+    {
+        m_count = 0;
+        m_sum = 0;
+        m_extremes_stale = false;
+        m_row_values.clear();
+        m_row_included.clear();
+        if (track_rows) {
+            m_row_values.resize(table.size());
+            m_row_included.resize(table.size());
+        }
+
+        for (size_t i = begin; i < end; ++i) {
+            if (!tv.is_row_attached(i))
+                continue;
+            size_t row = tv.get_source_ndx(i);
+            if (table.is_null(m_column, row))
+                continue;
+            T value = get_value<T>(table, m_column, m_type, row);
+            add(value);
+            if (track_rows) {
+                m_row_values[row] = value;
+                m_row_included[row] = true;
+            }
+        }
+    }
+
+    bool update(Table const& table, CollectionChangeBuilder const& changes,
+                std::function<bool (size_t)> const& matches) override
+    {
+        const size_t old_size = m_row_values.size(), new_size = table.size();
+        if (!rows_kept_in_place(changes, old_size, new_size))
+            return false;
+
+        // Rows moved by move_last_over() keep their values, so pick them up
+        // before the slots they were moved from are cleared as deletions
+        std::vector<std::pair<size_t, T>> moved;
+        std::vector<size_t> move_targets;
+        for (auto const& move : changes.moves) {
+            move_targets.push_back(move.to);
+            if (move.from < old_size && m_row_included[move.from]) {
+                moved.emplace_back(move.to, m_row_values[move.from]);
+                m_row_included[move.from] = false;
+            }
+        }
+        std::sort(move_targets.begin(), move_targets.end());
+
+        for (auto range : changes.deletions) {
+            for (size_t row = range.first, end = std::min(range.second, old_size); row < end; ++row)
+                remove_row(row);
+            if (range.second >= old_size)
+                break;
+        }
+
+        m_row_values.resize(new_size);
+        m_row_included.resize(new_size);
+        for (auto const& move : moved) {
+            m_row_values[move.first] = move.second;
+            m_row_included[move.first] = true;
+        }
+
+        // Newly inserted rows and modified rows may have a new value and may
+        // have started or stopped matching the query
+        std::vector<size_t> candidates;
+        for (auto row : changes.insertions.as_indexes()) {
+            if (!std::binary_search(move_targets.begin(), move_targets.end(), row))
+                candidates.push_back(row);
+        }
+        size_t inserted = candidates.size();
+        for (auto row : changes.modifications.as_indexes())
+            candidates.push_back(row);
+        std::inplace_merge(candidates.begin(), candidates.begin() + inserted, candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        for (size_t row : candidates) {
+            remove_row(row);
+            if (table.is_null(m_column, row) || !matches(row))
+                continue;
+            T value = get_value<T>(table, m_column, m_type, row);
+            add(value);
+            m_row_values[row] = value;
+            m_row_included[row] = true;
+        }
+
+        if (m_extremes_stale)
+            recompute_extremes();
+        return true;
+    }
+
+    LiveAggregate::Values get() const override
+    {
+        REALM_ASSERT(!m_extremes_stale);
+        LiveAggregate::Values values;
+        values.count = m_count;
+        if (m_count) {
+            values.min = to_mixed(m_min, m_type);
+            values.max = to_mixed(m_max, m_type);
+        }
+        if (m_type != type_DateTime) {
+            values.sum = Mixed(m_sum);
+            if (m_count)
+                values.average = Mixed(double(m_sum) / m_count);
+        }
+        return values;
+    }
+
+private:
+    const size_t m_column;
+    const DataType m_type;
+
+    size_t m_count = 0;
+    Sum m_sum = 0;
+    // The min and max, along with how many of the values are equal to them.
+    // When the last one is removed they have to be recomputed from the
+    // tracked rows.
+    T m_min{}, m_max{};
+    size_t m_min_count = 0, m_max_count = 0;
+    bool m_extremes_stale = false;
+
+    // Indexed by row, with m_row_included as the bitmap of which rows are
+    // part of the totals. A flat array is far smaller per row than a node
+    // based container, so this is cheaper than keying on the included rows
+    // unless the results are a tiny fraction of the table.
+    std::vector<T> m_row_values;
+    std::vector<bool> m_row_included;
+
+    void add(T value)
+    {
+        ++m_count;
+        m_sum += value;
+        if (m_extremes_stale)
+            return;
+        if (m_count == 1) {
+            m_min = m_max = value;
+            m_min_count = m_max_count = 1;
+            return;
+        }
+        if (value < m_min) {
+            m_min = value;
+            m_min_count = 1;
+        }
+        else if (value == m_min) {
+            ++m_min_count;
+        }
+        if (m_max < value) {
+            m_max = value;
+            m_max_count = 1;
+        }
+        else if (value == m_max) {
+            ++m_max_count;
+        }
+    }
+
+    void remove_row(size_t row)
+    {
+        if (!m_row_included[row])
+            return;
+        m_row_included[row] = false;
+
+        T value = m_row_values[row];
+        if (--m_count == 0) {
+            // Start over from exactly zero so that rounding errors in
+            // floating point sums don't outlive the values
+            m_sum = 0;
+            m_extremes_stale = false;
+            return;
+        }
+        m_sum -= value;
+        if (m_extremes_stale)
+            return;
+        if (value == m_min && --m_min_count == 0)
+            m_extremes_stale = true;
+        if (value == m_max && --m_max_count == 0)
+            m_extremes_stale = true;
+    }
+
+    void recompute_extremes()
+    {
+        m_extremes_stale = false;
+        size_t count = m_count;
+        m_count = 0;
+        Sum sum = m_sum;
+        for (size_t row = 0; row < m_row_values.size(); ++row) {
+            if (m_row_included[row])
+                add(m_row_values[row]);
+        }
+        REALM_ASSERT(m_count == count);
+        m_sum = sum;
+    }
+};
+
+std::unique_ptr<AggregateState> make_state(size_t column, DataType type)
+{
+    switch (type) {
+        case type_Int:
+        case type_DateTime:
+            return std::make_unique<TypedAggregateState<int64_t, int64_t>>(column, type);
+        case type_Float:
+            return std::make_unique<TypedAggregateState<float, double>>(column, type);
+        case type_Double:
+            return std::make_unique<TypedAggregateState<double, double>>(column, type);
+        default:
+            REALM_UNREACHABLE();
+    }
+}
+
+bool same_value(util::Optional<Mixed> const& a, util::Optional<Mixed> const& b)
+{
+    if (!a || !b)
+        return !a == !b;
+    if (a->get_type() != b->get_type())
+        return false;
+    switch (a->get_type()) {
+        case type_Int:
+            return a->get_int() == b->get_int();
+        case type_Float:
+            return a->get_float() == b->get_float();
+        case type_Double:
+            return a->get_double() == b->get_double();
+        case type_DateTime:
+            return a->get_datetime().get_datetime() == b->get_datetime().get_datetime();
+        default:
+            REALM_UNREACHABLE();
+    }
+}
+
+bool same_values(LiveAggregate::Values const& a, LiveAggregate::Values const& b)
+{
+    return a.count == b.count && same_value(a.min, b.min) && same_value(a.max, b.max)
+        && same_value(a.sum, b.sum) && same_value(a.average, b.average);
+}
+} // anonymous namespace
+
+AggregateNotifier::AggregateNotifier(Results const& target, size_t column)
+: CollectionNotifier(target.get_realm())
+, m_column(column)
+, m_sort(target.get_sort())
+, m_offset(target.get_offset())
+, m_limit(target.get_limit())
+, m_from_linkview(target.get_linkview().get() != nullptr)
+{
+    Query q = target.get_query();
+    auto& table = *q.get_table();
+    m_type = table.get_column_type(column);
+
+    // The query can only depend on rows other than the one being evaluated
+    // through links, and modifications to those aren't tracked per row here
+    m_can_track_rows = !m_from_linkview && m_offset == 0 && m_limit == size_t(-1);
+    for (size_t i = 0, count = table.get_column_count(); i < count; ++i) {
+        auto type = table.get_column_type(i);
+        if (type == type_Link || type == type_LinkList || type == type_Table)
+            m_can_track_rows = false;
+    }
+
+    set_table(table);
+    m_query_handover = Realm::Internal::get_shared_group(*get_realm()).export_for_handover(q, MutableSourcePayload::Move);
+}
+
+AggregateNotifier::~AggregateNotifier() = default;
+
+void AggregateNotifier::release_data() noexcept
+{
+    m_query = nullptr;
+    m_state = nullptr;
+}
+
+// See the comment in ResultsNotifier for which members can be used from where.
+// In addition to those, m_delivered_values is read by get_values() on the
+// target thread.
+
+bool AggregateNotifier::do_add_required_change_info(TransactionChangeInfo& info)
+{
+    REALM_ASSERT(m_query);
+    m_info = &info;
+
+    m_tracking_changes = m_state && m_can_track_rows && have_callbacks();
+    if (!m_tracking_changes)
+        return false;
+
+    auto table_ndx = m_query->get_table()->get_index_in_group();
+    if (info.table_moves_needed.size() <= table_ndx)
+        info.table_moves_needed.resize(table_ndx + 1);
+    info.table_moves_needed[table_ndx] = true;
+    return true;
+}
+
+void AggregateNotifier::recompute()
+{
+    if (!m_state)
+        m_state = make_state(m_column, m_type);
+
+    // The order of the rows only matters if some of them are left out
+    TableView tv;
+    if (m_limit != size_t(-1)) {
+        tv = find_all_limited(*m_query, m_sort, m_limit < size_t(-1) - m_offset ? m_offset + m_limit : size_t(-1));
+    }
+    else {
+        tv = m_query->find_all();
+        if (m_sort && m_offset > 0)
+            tv.sort(m_sort.column_indices, m_sort.ascending);
+    }
+
+    const size_t end = m_limit < tv.size() - std::min(m_offset, tv.size()) ? m_offset + m_limit : tv.size();
+    m_state->reset(*m_query->get_table(), tv, std::min(m_offset, end), end, m_can_track_rows);
+}
+
+void AggregateNotifier::run()
+{
+    REALM_ASSERT(m_info);
+
+    if (!have_callbacks()) {
+        // Without change information for this version the totals can't be
+        // updated incrementally any more, so release the memory for the rows
+        m_state = nullptr;
+        m_values = util::none;
+        return;
+    }
+
+    // Make an empty tableview from the query to get the table version, since
+    // Query doesn't expose it
+    auto version = m_query->find_all(0, 0, 0).sync_if_needed();
+    if (m_values && version == m_last_seen_version)
+        return;
+    m_last_seen_version = version;
+
+    auto& table = *m_query->get_table();
+    bool updated = false;
+    if (m_state && m_tracking_changes) {
+        size_t table_ndx = table.get_index_in_group();
+        if (table_ndx >= m_info->tables.size()) {
+            updated = true;
+        }
+        else {
+            auto const& changes = m_info->tables[table_ndx];
+            size_t changed = changes.insertions.count() + changes.modifications.count();
+            if (changed * min_rows_per_changed_row <= table.size()) {
+                updated = m_state->update(table, changes, [&](size_t row) {
+                    return m_query->count(row, row + 1, 1) != 0;
+                });
+            }
+        }
+    }
+    if (!updated)
+        recompute();
+
+    auto values = m_state->get();
+    m_values_changed = !m_values || !same_values(*m_values, values);
+    m_values = std::move(values);
+}
+
+void AggregateNotifier::do_prepare_handover(SharedGroup&)
+{
+    if (!m_values_changed)
+        return;
+    m_values_changed = false;
+    m_handover_values = m_values;
+
+    // The callbacks are only called when there are changes, so report the
+    // new values as a modification of the single aggregate
+    CollectionChangeBuilder change;
+    change.modifications.add(0);
+    add_changes(std::move(change));
+}
+
+bool AggregateNotifier::do_deliver(SharedGroup&)
+{
+    auto lock = lock_target();
+
+    // Target realm being null here indicates that we were unregistered while we
+    // were in the process of advancing the Realm version and preparing for
+    // delivery, i.e. the aggregate was destroyed from the "wrong" thread
+    if (!get_realm()) {
+        return false;
+    }
+
+    if (m_handover_values) {
+        m_delivered_values = std::move(m_handover_values);
+        m_handover_values = util::none;
+    }
+    return bool(m_delivered_values);
+}
+
+void AggregateNotifier::do_attach_to(SharedGroup& sg)
+{
+    REALM_ASSERT(m_query_handover);
+    m_query = sg.import_from_handover(std::move(m_query_handover));
+}
+
+void AggregateNotifier::do_detach_from(SharedGroup& sg)
+{
+    REALM_ASSERT(m_query);
+
+    m_query_handover = sg.export_for_handover(*m_query, MutableSourcePayload::Move);
+    m_query = nullptr;
+}
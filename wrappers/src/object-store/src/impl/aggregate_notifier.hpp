@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef REALM_AGGREGATE_NOTIFIER_HPP
+#define REALM_AGGREGATE_NOTIFIER_HPP
+
+#include "impl/collection_notifier.hpp"
+#include "live_aggregate.hpp"
+#include "results.hpp"
+
+#include <realm/group_shared.hpp>
+
+namespace realm {
+namespace _impl {
+class AggregateState;
+
+class AggregateNotifier : public CollectionNotifier {
+public:
+    AggregateNotifier(Results const& target, size_t column);
+    ~AggregateNotifier();
+
+    // The values as of the most recently delivered version, or none if they
+    // haven't been delivered yet. Can only be used on the target thread.
+    util::Optional<LiveAggregate::Values> const& get_values() const noexcept { return m_delivered_values; }
+
+private:
+    const size_t m_column;
+    DataType m_type;
+
+    // Only the m_limit rows (or all of them if it's -1) starting at m_offset
+    // are aggregated, so the sort order only matters if either is set
+    const SortOrder m_sort;
+    const size_t m_offset;
+    const size_t m_limit;
+    const bool m_from_linkview;
+
+    // Can the totals be updated from the table's changes rather than
+    // recomputed? Requires that the rows are in table order and that the
+    // query doesn't depend on other tables.
+    bool m_can_track_rows;
+
+    // The source Query, in handover form iff m_sg is null
+    std::unique_ptr<SharedGroup::Handover<Query>> m_query_handover;
+    std::unique_ptr<Query> m_query;
+
+    // The table version from the last time the values were updated
+    uint_fast64_t m_last_seen_version = -1;
+    TransactionChangeInfo* m_info = nullptr;
+
+    // The running totals, and the value of each row when m_can_track_rows is
+    // set. The row values are stored densely, costing sizeof(T) plus one bit
+    // for every row of the table. They are only updated from the changes if
+    // change information was requested for every version since they were last
+    // computed.
+    std::unique_ptr<AggregateState> m_state;
+    bool m_tracking_changes = false;
+
+    // The values calculated in run(), handed over in do_prepare_handover()
+    // and delivered in do_deliver()
+    util::Optional<LiveAggregate::Values> m_values;
+    bool m_values_changed = false;
+    util::Optional<LiveAggregate::Values> m_handover_values;
+    util::Optional<LiveAggregate::Values> m_delivered_values;
+
+    void recompute();
+
+    void run() override;
+    void do_prepare_handover(SharedGroup&) override;
+    bool do_deliver(SharedGroup& sg) override;
+    bool do_add_required_change_info(TransactionChangeInfo& info) override;
+
+    void release_data() noexcept override;
+    void do_attach_to(SharedGroup& sg) override;
+    void do_detach_from(SharedGroup& sg) override;
+};
+
+} // namespace _impl
+} // namespace realm
+
+#endif /* REALM_AGGREGATE_NOTIFIER_HPP */
@@ -71,7 +71,7 @@ CollectionNotifier::~CollectionNotifier()
     unregister();
 }
 
-size_t CollectionNotifier::add_callback(CollectionChangeCallback callback)
+size_t CollectionNotifier::add_callback(CollectionChangeCallback callback, NotificationPriority priority)
 {
     m_realm->verify_thread();
 
@@ -87,7 +87,8 @@ size_t CollectionNotifier::add_callback(CollectionChangeCallback callback)
 
     std::lock_guard<std::mutex> lock(m_callback_mutex);
     auto token = next_token();
-    m_callbacks.push_back({std::move(callback), token, false});
+    m_callbacks.push_back({std::move(callback), token, false, priority});
+    update_priority();
     if (m_callback_index == npos) { // Don't need to wake up if we're already sending notifications
         Realm::Internal::get_coordinator(*m_realm).send_commit_notifications();
         m_have_callbacks = true;
@@ -119,9 +120,24 @@ void CollectionNotifier::remove_callback(size_t token)
         m_callbacks.erase(it);
 
         m_have_callbacks = !m_callbacks.empty();
+        update_priority();
     }
 }
 
+void CollectionNotifier::update_priority()
+{
+    if (m_callbacks.empty()) {
+        m_priority = NotificationPriority::Normal;
+        return;
+    }
+
+    auto priority = NotificationPriority::Background;
+    for (auto& callback : m_callbacks) {
+        priority = std::min(priority, callback.priority);
+    }
+    m_priority = priority;
+}
+
 void CollectionNotifier::unregister() noexcept
 {
     std::lock_guard<std::mutex> lock(m_realm_mutex);
@@ -176,6 +192,7 @@ void CollectionNotifier::add_required_change_info(TransactionChangeInfo& info)
 void CollectionNotifier::prepare_handover()
 {
     REALM_ASSERT(m_sg);
+    std::lock_guard<std::mutex> lock(m_handover_mutex);
     m_sg_version = m_sg->get_version_of_current_transaction();
     do_prepare_handover(*m_sg);
 }
@@ -189,6 +206,7 @@ bool CollectionNotifier::deliver(Realm& realm, SharedGroup& sg, std::exception_p
         }
     }
 
+    std::lock_guard<std::mutex> lock(m_handover_mutex);
     if (err) {
         m_error = err;
         return have_callbacks();
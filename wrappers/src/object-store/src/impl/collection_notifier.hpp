@@ -69,7 +69,8 @@ public:
     // Add a callback to be called each time the collection changes
     // This can only be called from the target collection's thread
     // Returns a token which can be passed to remove_callback()
-    size_t add_callback(CollectionChangeCallback callback);
+    size_t add_callback(CollectionChangeCallback callback,
+                        NotificationPriority priority = NotificationPriority::Normal);
     // Remove a previously added token. The token is no longer valid after
     // calling this function and must not be used again. This function can be
     // called from any thread.
@@ -82,8 +83,13 @@ public:
 
     // Get the SharedGroup version which this collection can attach to (if it's
     // in handover mode), or can deliver to (if it's been handed over to the BG worker alredad)
+    // Only safe to call on the worker thread or from within deliver()
     SharedGroup::VersionID version() const noexcept { return m_sg_version; }
 
+    // The highest priority of any of the current callbacks, or Normal if
+    // there aren't any. May be stale, as it's updated on the target thread.
+    NotificationPriority priority() const noexcept { return m_priority; }
+
     // Release references to all core types
     // This is called on the worker thread to ensure that non-thread-safe things
     // can be destroyed on the correct thread, even if the last reference to the
@@ -126,6 +132,10 @@ private:
     mutable std::mutex m_realm_mutex;
     std::shared_ptr<Realm> m_realm;
 
+    // Held by prepare_handover() and deliver() so that a notifier is never
+    // delivered while it's part way through being handed over
+    std::mutex m_handover_mutex;
+
     SharedGroup::VersionID m_sg_version;
     SharedGroup* m_sg = nullptr;
 
@@ -140,6 +150,7 @@ private:
         CollectionChangeCallback fn;
         size_t token;
         bool initial_delivered;
+        NotificationPriority priority;
     };
 
     // Currently registered callbacks and a mutex which must always be held
@@ -152,6 +163,9 @@ private:
     // It's okay if this value is stale as at worst it'll result in us doing
     // some extra work.
     std::atomic<bool> m_have_callbacks = {false};
+    // Cached priority of m_callbacks, for the same reason
+    std::atomic<NotificationPriority> m_priority = {NotificationPriority::Normal};
+    void update_priority();
 
     // Iteration variable for looping over callbacks
     // remove_callback() updates this when needed
@@ -20,30 +20,201 @@
 
 #include "impl/realm_coordinator.hpp"
 
-#include <realm/commit_log.hpp>
-#include <realm/replication.hpp>
+#ifdef __linux__
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <typeinfo>
+#include <unistd.h>
+#endif
 
 using namespace realm;
 using namespace realm::_impl;
 
+#ifdef __linux__
+
+namespace {
+// Write a byte to a pipe to notify anyone waiting for data on the pipe
+void notify_fd(int fd)
+{
+    while (true) {
+        char c = 0;
+        ssize_t ret = write(fd, &c, 1);
+        if (ret == 1) {
+            break;
+        }
+
+        // If the pipe's buffer is full, we need to read some of the old data in
+        // it to make space. We don't just read in the code waiting for
+        // notifications so that we can notify multiple waiters with a single
+        // write.
+        assert(ret == -1 && errno == EAGAIN);
+        char buff[1024];
+        read(fd, buff, sizeof buff);
+    }
+}
+} // anonymous namespace
+
+void ExternalCommitHelper::FdHolder::close()
+{
+    if (m_fd != -1) {
+        ::close(m_fd);
+    }
+    m_fd = -1;
+}
+
+// Inter-process notifications of changes are done using a named pipe next to
+// the Realm file, exactly as on Apple platforms and Android. Everyone who wants
+// to be notified of commits waits for data to become available on the pipe,
+// and anyone who commits a write transaction writes a byte to it after
+// releasing the write lock. No one ever reads from the pipe: the data written
+// is meaningless, and reading from a pipe shared between processes would steal
+// wakeups from the other listeners.
+//
+// The listener thread waits on the pipe with edge-triggered epoll, which
+// reports each burst of writes as a single readiness event. Commits made while
+// on_change() is running are therefore coalesced into one further call rather
+// than one call per commit.
 ExternalCommitHelper::ExternalCommitHelper(RealmCoordinator& parent)
-//: m_parent(parent)
-//, m_history(realm::make_client_history(parent.get_path(), parent.get_encryption_key().data()))
-//, m_sg(*m_history, parent.is_in_memory() ? SharedGroup::durability_MemOnly : SharedGroup::durability_Full,
-//       parent.get_encryption_key().data())
-//, m_thread(std::async(std::launch::async, [=] {
-//    m_sg.begin_read();
-//    while (m_sg.wait_for_change()) {
-//        m_sg.end_read();
-//        m_sg.begin_read();
-//        m_parent.on_change();
-//    }
-//}))
+: m_parent(parent)
 {
+    m_epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epfd == -1) {
+        throw std::system_error(errno, std::system_category());
+    }
+
+    auto path = parent.get_path() + ".note";
+
+    // Create and open the named pipe
+    int ret = mkfifo(path.c_str(), 0600);
+    if (ret == -1) {
+        int err = errno;
+        if (err == ENOTSUP || err == EPERM) {
+            // Filesystem doesn't support named pipes, so try putting it in tmp instead
+            // Hash collisions are okay here because they just result in doing
+            // extra work, as opposed to correctness problems
+            std::ostringstream ss;
+
+            const char* tmp_dir = getenv("TMPDIR");
+            std::string dir = tmp_dir && *tmp_dir ? tmp_dir : "/tmp";
+            ss << dir;
+            if (dir.back() != '/')
+                ss << '/';
+            ss << "realm_" << std::hash<std::string>()(path) << ".note";
+            path = ss.str();
+            ret = mkfifo(path.c_str(), 0600);
+            err = errno;
+        }
+        // the fifo already existing isn't an error
+        if (ret == -1 && err != EEXIST) {
+            throw std::system_error(err, std::system_category());
+        }
+    }
+
+    // Make writing to the pipe return -1 when the pipe's buffer is full
+    // rather than blocking until there's space available
+    m_notify_fd = open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (m_notify_fd == -1) {
+        throw std::system_error(errno, std::system_category());
+    }
+
+    m_shutdown_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_shutdown_fd == -1) {
+        throw std::system_error(errno, std::system_category());
+    }
+
+    struct epoll_event event{};
+    event.events = EPOLLIN | EPOLLET;
+    event.data.fd = m_notify_fd;
+    if (epoll_ctl(m_epfd, EPOLL_CTL_ADD, m_notify_fd, &event) == -1) {
+        throw std::system_error(errno, std::system_category());
+    }
+
+    event.events = EPOLLIN;
+    event.data.fd = m_shutdown_fd;
+    if (epoll_ctl(m_epfd, EPOLL_CTL_ADD, m_shutdown_fd, &event) == -1) {
+        throw std::system_error(errno, std::system_category());
+    }
+
+    m_thread = std::thread([=] {
+        try {
+            listen();
+        }
+        catch (std::exception const& e) {
+            fprintf(stderr, "uncaught exception in notifier thread: %s: %s\n", typeid(e).name(), e.what());
+            throw;
+        }
+        catch (...) {
+            fprintf(stderr, "uncaught exception in notifier thread\n");
+            throw;
+        }
+    });
 }
 
 ExternalCommitHelper::~ExternalCommitHelper()
 {
-    //m_sg.wait_for_change_release();
-    //m_thread.wait(); // Wait for the thread to exit
+    uint64_t value = 1;
+    write(m_shutdown_fd, &value, sizeof value);
+    m_thread.join(); // Wait for the thread to exit
 }
+
+void ExternalCommitHelper::listen()
+{
+    pthread_setname_np(pthread_self(), "Realm notifier");
+
+    while (true) {
+        // Both fds can be ready at once, so ask for both to ensure that a
+        // shutdown request is never hidden behind a commit notification
+        struct epoll_event events[2];
+        int ret = epoll_wait(m_epfd, events, 2, -1);
+
+        if (ret == -1 && errno == EINTR) {
+            // Interrupted system call, try again.
+            continue;
+        }
+
+        assert(ret >= 0);
+        if (ret == 0) {
+            // Spurious wakeup; just wait again
+            continue;
+        }
+
+        bool changed = false;
+        for (int i = 0; i < ret; ++i) {
+            if (events[i].data.fd == m_shutdown_fd) {
+                return;
+            }
+            assert(events[i].data.fd == m_notify_fd);
+            changed = true;
+        }
+
+        if (changed) {
+            m_parent.on_change();
+        }
+    }
+}
+
+void ExternalCommitHelper::notify_others()
+{
+    notify_fd(m_notify_fd);
+}
+
+#else // __linux__
+
+ExternalCommitHelper::ExternalCommitHelper(RealmCoordinator&)
+{
+}
+
+ExternalCommitHelper::~ExternalCommitHelper()
+{
+}
+
+#endif // __linux__
@@ -18,11 +18,9 @@
 
 #include <realm/group_shared.hpp>
 
-#include <future>
+#include <thread>
 
 namespace realm {
-class Replication;
-
 namespace _impl {
 class RealmCoordinator;
 
@@ -31,18 +29,52 @@ public:
     ExternalCommitHelper(RealmCoordinator& parent);
     ~ExternalCommitHelper();
 
-    // A no-op in this version, but needed for the Apple version
+#ifdef __linux__
+    void notify_others();
+#else
+    // A no-op on platforms without a cross-process notification mechanism
     void notify_others() { }
+#endif
 
+#ifdef __linux__
 private:
-    RealmCoordinator& m_parent;
+    // A RAII holder for a file descriptor which automatically closes the wrapped
+    // fd when it's deallocated
+    class FdHolder {
+    public:
+        FdHolder() = default;
+        ~FdHolder() { close(); }
+        operator int() const { return m_fd; }
+
+        FdHolder& operator=(int new_fd) {
+            close();
+            m_fd = new_fd;
+            return *this;
+        }
+
+    private:
+        int m_fd = -1;
+        void close();
 
-    // A shared group used to listen for changes
-    std::unique_ptr<Replication> m_history;
-    SharedGroup m_sg;
+        FdHolder& operator=(FdHolder const&) = delete;
+        FdHolder(FdHolder const&) = delete;
+    };
+
+    void listen();
+
+    RealmCoordinator& m_parent;
 
     // The listener thread
-    std::future<void> m_thread;
+    std::thread m_thread;
+
+    // Read-write file descriptor for the named pipe which is waited on for
+    // changes and written to when a commit is made
+    FdHolder m_notify_fd;
+    // File descriptor for epoll
+    FdHolder m_epfd;
+    // An eventfd used to tell the listener thread that it should shut down
+    FdHolder m_shutdown_fd;
+#endif
 };
 
 } // namespace _impl
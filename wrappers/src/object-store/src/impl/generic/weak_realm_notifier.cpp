@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "impl/weak_realm_notifier.hpp"
+
+#ifdef __linux__
+#include "shared_realm.hpp"
+
+#include <errno.h>
+#include <mutex>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace realm;
+using namespace realm::_impl;
+
+namespace realm {
+namespace _impl {
+
+class ThreadNotificationQueue {
+public:
+    ThreadNotificationQueue() : m_fd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) { }
+    ~ThreadNotificationQueue()
+    {
+        if (m_fd != -1)
+            ::close(m_fd);
+    }
+
+    ThreadNotificationQueue(const ThreadNotificationQueue&) = delete;
+    ThreadNotificationQueue& operator=(const ThreadNotificationQueue&) = delete;
+
+    int fd() const { return m_fd; }
+
+    // Called on any thread
+    void push(const std::shared_ptr<Realm>& realm)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            // The coordinator notifies every Realm on every commit, so a Realm
+            // which hasn't been delivered to yet only needs to be queued once
+            for (auto& pending : m_pending) {
+                if (!pending.owner_before(realm) && !realm.owner_before(pending))
+                    return;
+            }
+            m_pending.emplace_back(realm);
+        }
+
+        uint64_t value = 1;
+        while (write(m_fd, &value, sizeof(value)) < 0 && errno == EINTR)
+            ;
+        // EAGAIN means the counter is saturated, in which case the fd is
+        // already readable and there's nothing more to do
+    }
+
+    // Called on the owning thread
+    size_t drain()
+    {
+        // Reset the eventfd before taking the pending Realms so that a push()
+        // racing with this will signal it again rather than being lost
+        uint64_t value;
+        while (read(m_fd, &value, sizeof(value)) < 0 && errno == EINTR)
+            ;
+
+        std::vector<std::weak_ptr<Realm>> pending;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            pending.swap(m_pending);
+        }
+
+        size_t notified = 0;
+        for (auto& entry : pending) {
+            if (auto realm = entry.lock()) {
+                if (!realm->is_closed()) {
+                    realm->notify();
+                    ++notified;
+                }
+            }
+        }
+        return notified;
+    }
+
+    static std::shared_ptr<ThreadNotificationQueue> get_for_current_thread()
+    {
+        // Notifiers hold a strong reference to the queue, so the fd stays
+        // valid for them after the thread itself has exited
+        static thread_local std::shared_ptr<ThreadNotificationQueue> queue;
+        if (!queue) {
+            auto new_queue = std::make_shared<ThreadNotificationQueue>();
+            if (new_queue->fd() == -1)
+                return nullptr;
+            queue = std::move(new_queue);
+        }
+        return queue;
+    }
+
+private:
+    const int m_fd;
+    std::mutex m_mutex;
+    std::vector<std::weak_ptr<Realm>> m_pending;
+};
+
+} // namespace _impl
+} // namespace realm
+
+WeakRealmNotifier::WeakRealmNotifier(const std::shared_ptr<Realm>& realm, bool cache)
+: WeakRealmNotifierBase(realm, cache)
+, m_queue(ThreadNotificationQueue::get_for_current_thread())
+{
+}
+
+void WeakRealmNotifier::notify()
+{
+    if (!m_queue)
+        return;
+    if (auto realm = this->realm()) {
+        m_queue->push(realm);
+    }
+}
+
+int WeakRealmNotifier::get_thread_notification_fd()
+{
+    auto queue = ThreadNotificationQueue::get_for_current_thread();
+    return queue ? queue->fd() : -1;
+}
+
+size_t WeakRealmNotifier::drain_thread_notifications()
+{
+    auto queue = ThreadNotificationQueue::get_for_current_thread();
+    return queue ? queue->drain() : 0;
+}
+
+#endif // __linux__
@@ -23,11 +23,37 @@ class Realm;
 
 namespace _impl {
 
+#ifdef __linux__
+// Notifications for all of the Realms opened on a thread are queued up here,
+// and an eventfd is signalled so that the thread's event loop knows to deliver
+// them by calling WeakRealmNotifier::drain_thread_notifications()
+class ThreadNotificationQueue;
+#endif
+
 class WeakRealmNotifier : public WeakRealmNotifierBase {
 public:
+#ifdef __linux__
+    WeakRealmNotifier(const std::shared_ptr<Realm>& realm, bool cache);
+
+    // Asyncronously call notify() on the Realm on the appropriate thread
+    void notify();
+
+    // Get the eventfd which becomes readable whenever a Realm opened on the
+    // calling thread has pending notifications, or -1 if it could not be created
+    static int get_thread_notification_fd();
+
+    // Call notify() on each Realm opened on the calling thread which has
+    // pending notifications, and return the number of Realms notified
+    static size_t drain_thread_notifications();
+
+private:
+    std::shared_ptr<ThreadNotificationQueue> m_queue;
+#else
     using WeakRealmNotifierBase::WeakRealmNotifierBase;
 
+    // A no-op on platforms without a way to wake up the Realm's thread
     void notify() { }
+#endif
 };
 
 } // namespace _impl
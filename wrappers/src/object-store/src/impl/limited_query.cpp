@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2015 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "impl/limited_query.hpp"
+
+#include "results.hpp"
+
+#include <realm/query.hpp>
+
+#include <algorithm>
+#include <functional>
+
+using namespace realm;
+
+namespace {
+// Selecting the rows to sort is only worthwhile if it discards most of them
+const size_t min_rows_per_limited_row = 4;
+
+template<typename T, typename Getter, typename AddCondition>
+void restrict_to_first(Query const& source, TableView& tv, size_t limit, bool ascending, Getter get, AddCondition add_condition)
+{
+    // Every row which sorts before the limit'th one has a value at least as
+    // good as it in the first sort column
+    std::vector<T> values;
+    values.reserve(tv.size());
+    for (size_t i = 0; i < tv.size(); ++i) {
+        T value = get(i);
+        // NaN has no ordering for nth_element() to use and matches no
+        // comparisons, so just sort all of the rows if there are any
+        if (value != value)
+            return;
+        values.push_back(value);
+    }
+
+    T threshold;
+    if (ascending) {
+        std::nth_element(values.begin(), values.begin() + limit - 1, values.end());
+        threshold = values[limit - 1];
+    }
+    else {
+        std::nth_element(values.begin(), values.begin() + limit - 1, values.end(), std::greater<T>());
+        threshold = values[limit - 1];
+    }
+
+    Query query(source);
+    add_condition(query, threshold);
+    tv = query.find_all();
+}
+} // anonymous namespace
+
+TableView _impl::find_all_limited(Query& query, SortOrder const& sort, size_t limit)
+{
+    if (!sort || limit == 0)
+        return query.find_all(0, size_t(-1), limit);
+
+    TableView tv = query.find_all();
+    size_t col = sort.column_indices.front();
+    bool ascending = sort.ascending.front();
+    auto& table = *query.get_table();
+
+    // Nulls would need special handling since they sort before all values
+    // but don't match comparisons, so only non-nullable columns are filtered
+    if (tv.size() / min_rows_per_limited_row >= limit && !table.is_nullable(col)) {
+        switch (table.get_column_type(col)) {
+            case type_Int:
+                restrict_to_first<int64_t>(query, tv, limit, ascending,
+                                           [&](size_t i) { return tv.get_int(col, i); },
+                                           [&](Query& q, int64_t value) {
+                                               ascending ? q.less_equal(col, value) : q.greater_equal(col, value);
+                                           });
+                break;
+            case type_Float:
+                restrict_to_first<float>(query, tv, limit, ascending,
+                                         [&](size_t i) { return tv.get_float(col, i); },
+                                         [&](Query& q, float value) {
+                                             ascending ? q.less_equal(col, value) : q.greater_equal(col, value);
+                                         });
+                break;
+            case type_Double:
+                restrict_to_first<double>(query, tv, limit, ascending,
+                                          [&](size_t i) { return tv.get_double(col, i); },
+                                          [&](Query& q, double value) {
+                                              ascending ? q.less_equal(col, value) : q.greater_equal(col, value);
+                                          });
+                break;
+            default:
+                break;
+        }
+    }
+
+    tv.sort(sort.column_indices, sort.ascending);
+    return tv;
+}
@@ -0,0 +1,43 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2015 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef REALM_LIMITED_QUERY_HPP
+#define REALM_LIMITED_QUERY_HPP
+
+#include <realm/table_view.hpp>
+
+namespace realm {
+class Query;
+struct SortOrder;
+
+namespace _impl {
+// Run the query and sort the matching rows, where only the first `limit` rows
+// of the result are going to be used. Without a sort order this just stops the
+// query after `limit` matches. With one, the rows which can't be in the first
+// `limit` are filtered out by selecting the limit'th value of the first sort
+// column with nth_element() so that only the remaining rows are sorted, but
+// as all rows tied with that value are kept the returned TableView can still
+// contain more than `limit` rows. Floating point columns containing NaN have
+// no ordering to select with, so all of their rows are sorted.
+// Unlike a TableView returned by Query::find_all(), a sorted limited TableView
+// can't be updated with sync_if_needed() and has to be recreated instead.
+TableView find_all_limited(Query& query, SortOrder const& sort, size_t limit);
+} // namespace _impl
+} // namespace realm
+
+#endif /* REALM_LIMITED_QUERY_HPP */
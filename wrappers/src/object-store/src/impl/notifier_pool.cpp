@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "impl/notifier_pool.hpp"
+
+#include "impl/collection_notifier.hpp"
+
+#include <realm/commit_log.hpp>
+
+using namespace realm;
+using namespace realm::_impl;
+
+NotifierPool::NotifierPool(Realm::Config config, size_t thread_count)
+: m_config(std::move(config))
+, m_next_notifier(0)
+{
+    // The workers only ever read, so they don't need the schema
+    m_config.schema = nullptr;
+
+    m_slots.resize(thread_count > 1 ? thread_count - 1 : 0);
+    for (size_t i = 0; i < m_slots.size(); ++i)
+        m_threads.emplace_back([=] { work(i); });
+}
+
+NotifierPool::~NotifierPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_work_cv.notify_all();
+    for (auto& thread : m_threads)
+        thread.join();
+}
+
+void NotifierPool::work(size_t slot)
+{
+    size_t generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_work_cv.wait(lock, [&] { return m_stopping || m_generation != generation; });
+            if (m_stopping)
+                return;
+            generation = m_generation;
+        }
+
+        run_notifiers(&m_slots[slot]);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_running == 0)
+            m_done_cv.notify_one();
+    }
+}
+
+void NotifierPool::run_notifiers(Slot* slot)
+{
+    SharedGroup* sg = slot ? nullptr : m_source_sg;
+    try {
+        const size_t count = m_notifier_count;
+        for (size_t i = m_next_notifier++; i < count; i = m_next_notifier++) {
+            // Only pin the worker's version once it actually has something to
+            // do, as there may be fewer notifiers than threads
+            if (!sg) {
+                if (!slot->sg) {
+                    std::unique_ptr<Group> read_only_group;
+                    Realm::open_with_config(m_config, slot->history, slot->sg, read_only_group);
+                }
+                slot->sg->begin_read(m_version);
+                sg = slot->sg.get();
+            }
+
+            auto& notifier = *m_notifiers[i];
+            notifier.attach_to(*sg);
+            m_attached_to[i] = sg;
+            notifier.run();
+        }
+    }
+    catch (...) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_error)
+            m_error = std::current_exception();
+        // Don't start any more notifiers
+        m_next_notifier = m_notifier_count;
+    }
+}
+
+void NotifierPool::run(SharedGroup& sg, std::shared_ptr<CollectionNotifier> const* notifiers, size_t count,
+                       std::function<void ()> const& handover)
+{
+    m_source_sg = &sg;
+    m_version = sg.get_version_of_current_transaction();
+    m_notifiers = notifiers;
+    m_notifier_count = count;
+    m_attached_to.assign(count, nullptr);
+    m_next_notifier = 0;
+    m_error = nullptr;
+
+    // We don't know in advance which thread will run each notifier, so detach
+    // all of them, including the ones which will end up attached to sg again
+    for (size_t i = 0; i < count; ++i)
+        notifiers[i]->detach();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_generation;
+        m_running = m_threads.size();
+    }
+    m_work_cv.notify_all();
+    run_notifiers(nullptr);
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done_cv.wait(lock, [&] { return m_running == 0; });
+    }
+
+    // Anything skipped due to an error goes back to sg before the handover so
+    // that every notifier is attached to something
+    for (size_t i = 0; i < count; ++i) {
+        if (!m_attached_to[i]) {
+            notifiers[i]->attach_to(sg);
+            m_attached_to[i] = &sg;
+        }
+    }
+
+    // The workers are idle until the next batch, so their SharedGroups can be
+    // used from this thread for the handover and for detaching the notifiers
+    handover();
+
+    for (size_t i = 0; i < count; ++i) {
+        if (m_attached_to[i] != &sg) {
+            notifiers[i]->detach();
+            notifiers[i]->attach_to(sg);
+        }
+    }
+    for (auto& slot : m_slots) {
+        if (slot.sg && slot.sg->get_transact_stage() == SharedGroup::transact_Reading)
+            slot.sg->end_read();
+    }
+
+    m_notifiers = nullptr;
+    m_notifier_count = 0;
+    m_source_sg = nullptr;
+    if (m_error)
+        std::rethrow_exception(m_error);
+}
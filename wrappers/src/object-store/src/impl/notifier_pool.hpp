@@ -0,0 +1,102 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef REALM_NOTIFIER_POOL_HPP
+#define REALM_NOTIFIER_POOL_HPP
+
+#include "shared_realm.hpp"
+
+#include <realm/group_shared.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace realm {
+class Replication;
+
+namespace _impl {
+class CollectionNotifier;
+
+// Runs collection notifiers in parallel on a fixed set of worker threads. Each
+// worker has its own SharedGroup, which is pinned to the version of the
+// SharedGroup the notifiers are attached to while they run on it. Rather than
+// being split up in advance, the notifiers are taken one at a time by whichever
+// thread becomes free first, so a few slow queries don't hold up the rest.
+class NotifierPool {
+public:
+    // The thread calling run() does its share of the work, so this starts
+    // thread_count - 1 worker threads
+    NotifierPool(Realm::Config config, size_t thread_count);
+    ~NotifierPool();
+
+    // Call run() on each of the count notifiers starting at notifiers, which
+    // must all be attached to sg, and then call handover() on the calling
+    // thread. The notifiers may be attached to one of the workers'
+    // SharedGroups when handover() is called, and are attached to sg again
+    // when this returns. If a notifier throws, the first exception is
+    // rethrown after the notifiers are restored.
+    void run(SharedGroup& sg, std::shared_ptr<CollectionNotifier> const* notifiers, size_t count,
+             std::function<void ()> const& handover);
+
+private:
+    struct Slot {
+        std::unique_ptr<Replication> history;
+        std::unique_ptr<SharedGroup> sg;
+    };
+
+    Realm::Config m_config;
+
+    // One per worker thread, only used by that thread while notifiers are
+    // running and by the thread calling run() otherwise
+    std::vector<Slot> m_slots;
+
+    // The current batch of notifiers, and the SharedGroup each one was
+    // attached to by a worker (or null if it hasn't been run)
+    std::shared_ptr<CollectionNotifier> const* m_notifiers = nullptr;
+    size_t m_notifier_count = 0;
+    std::vector<SharedGroup*> m_attached_to;
+    SharedGroup* m_source_sg = nullptr;
+    SharedGroup::VersionID m_version;
+    std::atomic<size_t> m_next_notifier;
+
+    std::mutex m_mutex;
+    std::condition_variable m_work_cv;
+    std::condition_variable m_done_cv;
+    size_t m_generation = 0;
+    size_t m_running = 0;
+    bool m_stopping = false;
+    std::exception_ptr m_error;
+
+    // Declared last so that everything they use is initialized before they start
+    std::vector<std::thread> m_threads;
+
+    void work(size_t slot);
+    // Run notifiers from the current batch until there are none left, using
+    // the slot's SharedGroup, or the source SharedGroup if slot is null
+    void run_notifiers(Slot* slot);
+};
+
+} // namespace _impl
+} // namespace realm
+
+#endif /* REALM_NOTIFIER_POOL_HPP */
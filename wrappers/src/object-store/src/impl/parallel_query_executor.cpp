@@ -0,0 +1,202 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2015 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "impl/parallel_query_executor.hpp"
+
+#include <realm/commit_log.hpp>
+#include <realm/group_shared.hpp>
+#include <realm/query.hpp>
+#include <realm/table_view.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+using namespace realm;
+using namespace realm::_impl;
+
+class ParallelQueryExecutor::Worker {
+public:
+    Worker(Realm::Config const& config)
+    : m_config(config)
+    , m_thread([=] { work(); })
+    {
+    }
+
+    ~Worker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_cv.notify_one();
+        m_thread.join();
+    }
+
+    void post(std::function<void (Worker&)> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.push_back(std::move(job));
+        }
+        m_cv.notify_one();
+    }
+
+    // Get the worker's SharedGroup, opening it if this is the first use
+    // Must only be called from within a job
+    SharedGroup& shared_group()
+    {
+        if (!m_sg) {
+            std::unique_ptr<Group> read_only_group;
+            Realm::open_with_config(m_config, m_history, m_sg, read_only_group);
+        }
+        return *m_sg;
+    }
+
+private:
+    Realm::Config m_config;
+
+    // Only touched on the worker thread
+    std::unique_ptr<Replication> m_history;
+    std::unique_ptr<SharedGroup> m_sg;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::function<void (Worker&)>> m_jobs;
+    bool m_stopping = false;
+
+    // Declared last so that everything it uses is initialized before it starts
+    std::thread m_thread;
+
+    void work()
+    {
+        while (true) {
+            std::function<void (Worker&)> job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv.wait(lock, [&] { return m_stopping || !m_jobs.empty(); });
+                if (m_jobs.empty())
+                    return;
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+            job(*this);
+        }
+    }
+};
+
+ParallelQueryExecutor::ParallelQueryExecutor(Realm::Config config, size_t thread_count)
+{
+    // Read-only Realms are opened as a Group rather than a SharedGroup, so
+    // there's nothing to pin the workers' versions to
+    if (config.read_only)
+        return;
+
+    // The workers only ever read, so they don't need the schema
+    config.schema = nullptr;
+    for (size_t i = 0; i < thread_count; ++i)
+        m_workers.push_back(std::make_unique<Worker>(config));
+}
+
+ParallelQueryExecutor::~ParallelQueryExecutor() = default;
+
+template<typename T, typename Func>
+std::vector<T> ParallelQueryExecutor::run(SharedGroup& sg, Query& query, Func&& func)
+{
+    const size_t table_size = query.get_table()->size();
+    // Only committed versions can be handed over, and the workers wouldn't
+    // see the uncommitted changes of a write transaction anyway
+    const bool in_read = sg.get_transact_stage() == SharedGroup::transact_Reading;
+    const size_t range_count = in_read ? std::min(m_workers.size(), table_size / min_rows_per_range) : 0;
+    if (range_count < 2) {
+        std::vector<T> result;
+        result.push_back(func(query, 0, table_size));
+        return result;
+    }
+
+    const auto version = sg.get_version_of_current_transaction();
+    std::vector<std::future<T>> futures;
+    for (size_t i = 0; i < range_count; ++i) {
+        const size_t begin = table_size * i / range_count;
+        const size_t end = table_size * (i + 1) / range_count;
+
+        // Handover objects are single-use, so each worker needs its own. They're
+        // wrapped in a shared_ptr as std::function requires copyable functors.
+        auto handover = std::make_shared<std::unique_ptr<SharedGroup::Handover<Query>>>(
+            sg.export_for_handover(query, ConstSourcePayload::Copy));
+        auto promise = std::make_shared<std::promise<T>>();
+        futures.push_back(promise->get_future());
+
+        m_workers[i]->post([=](Worker& worker) {
+            SharedGroup* worker_sg = nullptr;
+            try {
+                worker_sg = &worker.shared_group();
+                worker_sg->begin_read(version);
+                auto worker_query = worker_sg->import_from_handover(std::move(*handover));
+                T result = func(*worker_query, begin, end);
+                worker_query.reset();
+                worker_sg->end_read();
+                promise->set_value(std::move(result));
+            }
+            catch (...) {
+                if (worker_sg && worker_sg->get_transact_stage() == SharedGroup::transact_Reading)
+                    worker_sg->end_read();
+                promise->set_exception(std::current_exception());
+            }
+        });
+    }
+
+    std::vector<T> results;
+    results.reserve(range_count);
+    for (auto& future : futures)
+        results.push_back(future.get());
+    return results;
+}
+
+size_t ParallelQueryExecutor::count(SharedGroup& sg, Query& query)
+{
+    auto counts = run<size_t>(sg, query, [](Query& q, size_t begin, size_t end) {
+        return q.count(begin, end);
+    });
+
+    size_t count = 0;
+    for (auto c : counts)
+        count += c;
+    return count;
+}
+
+std::vector<size_t> ParallelQueryExecutor::find_all(SharedGroup& sg, Query& query)
+{
+    auto ranges = run<std::vector<size_t>>(sg, query, [](Query& q, size_t begin, size_t end) {
+        TableView tv = q.find_all(begin, end);
+        std::vector<size_t> rows;
+        rows.reserve(tv.size());
+        for (size_t i = 0; i < tv.size(); ++i)
+            rows.push_back(tv.get_source_ndx(i));
+        return rows;
+    });
+
+    // The ranges are disjoint and in table order, so concatenating them keeps the rows sorted
+    std::vector<size_t> rows = std::move(ranges.front());
+    for (size_t i = 1; i < ranges.size(); ++i)
+        rows.insert(rows.end(), ranges[i].begin(), ranges[i].end());
+    return rows;
+}
@@ -0,0 +1,65 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2015 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef REALM_PARALLEL_QUERY_EXECUTOR_HPP
+#define REALM_PARALLEL_QUERY_EXECUTOR_HPP
+
+#include "shared_realm.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace realm {
+class Query;
+class SharedGroup;
+
+namespace _impl {
+// Evaluates queries by splitting their table into row ranges and running the
+// query over each range on a fixed set of worker threads. Each worker has its
+// own SharedGroup, and runs its part of the query in a read transaction at the
+// same version as the SharedGroup the query was handed over from, so the
+// partial results can simply be combined in row order.
+class ParallelQueryExecutor {
+public:
+    ParallelQueryExecutor(Realm::Config config, size_t thread_count);
+    ~ParallelQueryExecutor();
+
+    // Tables smaller than this are queried on the calling thread, as handing
+    // the query over to the workers would cost more than it saves
+    static const size_t min_rows_per_range = 64 * 1024;
+
+    // Number of rows matching query, which must belong to sg's current read
+    // transaction and must not be restricted to a LinkView or TableView.
+    // Queries in a write transaction are run on the calling thread.
+    size_t count(SharedGroup& sg, Query& query);
+
+    // Indices of the rows matching query in its table, in ascending order
+    std::vector<size_t> find_all(SharedGroup& sg, Query& query);
+
+private:
+    class Worker;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    template<typename T, typename Func>
+    std::vector<T> run(SharedGroup& sg, Query& query, Func&& func);
+};
+
+} // namespace _impl
+} // namespace realm
+
+#endif /* REALM_PARALLEL_QUERY_EXECUTOR_HPP */
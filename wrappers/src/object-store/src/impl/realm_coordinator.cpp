@@ -20,8 +20,11 @@
 
 #include "impl/collection_notifier.hpp"
 #include "impl/external_commit_helper.hpp"
+#include "impl/notifier_pool.hpp"
+#include "impl/parallel_query_executor.hpp"
 #include "impl/transact_log_handler.hpp"
 #include "impl/weak_realm_notifier.hpp"
+#include "binding_context.hpp"
 #include "object_store.hpp"
 #include "schema.hpp"
 
@@ -30,6 +33,8 @@
 #include <realm/lang_bind_helper.hpp>
 #include <realm/string_data.hpp>
 
+#include <algorithm>
+#include <thread>
 #include <unordered_map>
 
 using namespace realm;
@@ -136,6 +141,12 @@ RealmCoordinator::RealmCoordinator() = default;
 
 RealmCoordinator::~RealmCoordinator()
 {
+    {
+        std::lock_guard<std::mutex> lock(m_rate_limit_mutex);
+        m_closing = true;
+    }
+    m_rate_limit_cv.notify_all();
+
     std::lock_guard<std::mutex> coordinator_lock(s_coordinator_mutex);
     for (auto it = s_coordinators_per_path.begin(); it != s_coordinators_per_path.end(); ) {
         if (it->second.expired()) {
@@ -308,20 +319,60 @@ void RealmCoordinator::clean_up_dead_notifiers()
 
 void RealmCoordinator::on_change()
 {
+    auto const& limit = m_config.notification_rate_limit;
+    if (limit.min_interval.count() > 0 && !limit.skip_intermediate_versions) {
+        notify_realms();
+    }
+    if (!wait_for_rate_limit()) {
+        return;
+    }
+
     run_async_notifiers();
+    notify_realms();
+}
 
+void RealmCoordinator::notify_realms()
+{
     std::lock_guard<std::mutex> lock(m_realm_mutex);
     for (auto& realm : m_weak_realm_notifiers) {
         realm.notify();
     }
 }
 
+bool RealmCoordinator::wait_for_rate_limit()
+{
+    auto const& limit = m_config.notification_rate_limit;
+    std::unique_lock<std::mutex> lock(m_rate_limit_mutex);
+    if (limit.min_interval.count() > 0) {
+        // Commits made while we wait don't need a run of their own, as the
+        // notifiers are always advanced to the latest version when they run
+        if (!m_have_held_back_commit) {
+            m_first_held_back_commit = std::chrono::steady_clock::now();
+            m_have_held_back_commit = true;
+        }
+        // The latency is measured from the first commit which is still
+        // waiting, rather than from this call, so that a stream of commits
+        // can't push the run back. If max_latency is shorter than
+        // min_interval it wins, and the runs end up max_latency apart.
+        auto run_at = m_last_notifier_run + limit.min_interval;
+        if (limit.max_latency.count() > 0) {
+            run_at = std::min(run_at, m_first_held_back_commit + limit.max_latency);
+        }
+        m_rate_limit_cv.wait_until(lock, run_at, [&] { return m_closing; });
+    }
+    m_last_notifier_run = std::chrono::steady_clock::now();
+    m_have_held_back_commit = false;
+    return !m_closing;
+}
+
 namespace {
 class IncrementalChangeInfo {
 public:
     IncrementalChangeInfo(SharedGroup& sg,
-                          std::vector<std::shared_ptr<_impl::CollectionNotifier>>& notifiers)
+                          std::vector<std::shared_ptr<_impl::CollectionNotifier>>& notifiers,
+                          DecodedChangesets const* changesets=nullptr)
     : m_sg(sg)
+    , m_changesets(changesets)
     {
         if (notifiers.empty())
             return;
@@ -331,8 +382,10 @@ public:
         };
 
         // Sort the notifiers by their source version so that we can pull them
-        // all forward to the latest version in a single pass over the transaction log
-        std::sort(notifiers.begin(), notifiers.end(), cmp);
+        // all forward to the latest version in a single pass over the transaction
+        // log. The sort is stable so that notifiers which are already at the
+        // same version keep their order from run to run.
+        std::stable_sort(notifiers.begin(), notifiers.end(), cmp);
 
         // Preallocate the required amount of space in the vector so that we can
         // safely give out pointers to within the vector
@@ -351,7 +404,7 @@ public:
     bool advance_incremental(SharedGroup::VersionID version)
     {
         if (version != m_sg.get_version_of_current_transaction()) {
-            transaction::advance(m_sg, *m_current, version);
+            transaction::advance(m_sg, *m_current, version, m_changesets);
             m_info.push_back({
                 m_current->table_modifications_needed,
                 m_current->table_moves_needed,
@@ -362,14 +415,24 @@ public:
         return false;
     }
 
-    void advance_to_final(SharedGroup::VersionID version)
+    // If decoded is non-null, the changes advanced over are also decoded into
+    // it (if they fit in max_decoded_bytes) so that other SharedGroups can
+    // replay them
+    void advance_to_final(SharedGroup::VersionID version,
+                          std::shared_ptr<const DecodedChangeset>* decoded=nullptr,
+                          size_t max_decoded_bytes=0)
     {
-        if (!m_current) {
+        if (decoded) {
+            *decoded = transaction::advance_and_decode(m_sg, m_current, version, max_decoded_bytes);
+        }
+        else if (m_current) {
+            transaction::advance(m_sg, *m_current, version, m_changesets);
+        }
+        else {
             transaction::advance(m_sg, nullptr, version);
-            return;
         }
-
-        transaction::advance(m_sg, *m_current, version);
+        if (!m_current)
+            return;
 
         // We now need to combine the transaction change info objects so that all of
         // the notifiers see the complete set of changes from their first version to
@@ -408,6 +471,7 @@ private:
     std::vector<TransactionChangeInfo> m_info;
     TransactionChangeInfo* m_current = nullptr;
     SharedGroup& m_sg;
+    DecodedChangesets const* m_changesets;
 };
 } // anonymous namespace
 
@@ -418,6 +482,7 @@ void RealmCoordinator::run_async_notifiers()
     clean_up_dead_notifiers();
 
     if (m_notifiers.empty() && m_new_notifiers.empty()) {
+        publish_delivery_state({}, m_async_error);
         return;
     }
 
@@ -428,6 +493,7 @@ void RealmCoordinator::run_async_notifiers()
     if (m_async_error) {
         std::move(m_new_notifiers.begin(), m_new_notifiers.end(), std::back_inserter(m_notifiers));
         m_new_notifiers.clear();
+        publish_delivery_state({}, m_async_error);
         return;
     }
 
@@ -435,7 +501,7 @@ void RealmCoordinator::run_async_notifiers()
 
     // Advance all of the new notifiers to the most recent version, if any
     auto new_notifiers = std::move(m_new_notifiers);
-    IncrementalChangeInfo new_notifier_change_info(*m_advancer_sg, new_notifiers);
+    IncrementalChangeInfo new_notifier_change_info(*m_advancer_sg, new_notifiers, m_decoded_changesets.get());
 
     if (!new_notifiers.empty()) {
         REALM_ASSERT_3(m_advancer_sg->get_transact_stage(), ==, SharedGroup::transact_Reading);
@@ -469,39 +535,189 @@ void RealmCoordinator::run_async_notifiers()
     }
     REALM_ASSERT_3(m_advancer_sg->get_transact_stage(), ==, SharedGroup::transact_Ready);
 
-    // Make a copy of the notifiers vector and then release the lock to avoid
-    // blocking other threads trying to register or unregister notifiers while we run them
-    auto notifiers = m_notifiers;
+    // Release the lock to avoid blocking other threads trying to register
+    // notifiers while we run them. m_notifiers is only used on this thread.
     lock.unlock();
 
     // Advance the non-new notifiers to the same version as we advanced the new
     // ones to (or the latest if there were no new ones)
-    IncrementalChangeInfo change_info(*m_notifier_sg, notifiers);
-    for (auto& notifier : notifiers) {
+    IncrementalChangeInfo change_info(*m_notifier_sg, m_notifiers);
+    for (auto& notifier : m_notifiers) {
         notifier->add_required_change_info(change_info.current());
     }
-    change_info.advance_to_final(version);
+    // Decoding the changes costs about as much as the parse it saves a Realm,
+    // so it's only worth it if there's more than one Realm to replay them
+    size_t realm_count;
+    {
+        std::lock_guard<std::mutex> realm_lock(m_realm_mutex);
+        realm_count = std::count_if(m_weak_realm_notifiers.begin(), m_weak_realm_notifiers.end(),
+                                    [](auto const& notifier) { return !notifier.expired(); });
+    }
+    auto old_version = m_notifier_sg->get_version_of_current_transaction().version;
+    std::shared_ptr<const DecodedChangeset> decoded;
+    if (realm_count > 1) {
+        change_info.advance_to_final(version, &decoded, max_decoded_bytes);
+    }
+    else {
+        change_info.advance_to_final(version);
+    }
+    version = m_notifier_sg->get_version_of_current_transaction();
+    if (decoded) {
+        add_decoded_changeset(std::move(decoded));
+    }
+    else if (version.version != old_version) {
+        // Nothing can replay across the gap, so don't keep the old ones alive
+        m_decoded_changesets = nullptr;
+    }
 
     // Attach the new notifiers to the main SG and move them to the main list
     for (auto& notifier : new_notifiers) {
         notifier->attach_to(*m_notifier_sg);
     }
-    std::move(new_notifiers.begin(), new_notifiers.end(), std::back_inserter(notifiers));
+    std::move(new_notifiers.begin(), new_notifiers.end(), std::back_inserter(m_notifiers));
+
+    // Keep m_notifiers ordered by priority, reading each priority only once as
+    // they can be changed on other threads at any time. Priorities rarely
+    // change, so the list is normally already in order and nothing is moved.
+    const size_t group_count = size_t(NotificationPriority::Background) + 1;
+    std::vector<NotificationPriority> priorities;
+    priorities.reserve(m_notifiers.size());
+    for (auto& notifier : m_notifiers) {
+        priorities.push_back(notifier->priority());
+    }
+    if (!std::is_sorted(priorities.begin(), priorities.end())) {
+        NotifierList sorted;
+        sorted.reserve(m_notifiers.size());
+        for (size_t group = 0; group < group_count; ++group) {
+            for (size_t i = 0; i < m_notifiers.size(); ++i) {
+                if (size_t(priorities[i]) == group) {
+                    sorted.push_back(std::move(m_notifiers[i]));
+                }
+            }
+        }
+        m_notifiers = std::move(sorted);
+        std::stable_sort(priorities.begin(), priorities.end());
+    }
 
     // Change info is now all ready, so the notifiers can now perform their
-    // background work
-    for (auto& notifier : notifiers) {
-        notifier->run();
+    // background work, one priority group at a time. Each group is handed over
+    // and the Realms are told about it before the next one runs, so a slow
+    // Background query never delays the notifications for a High priority one.
+    bool published = false;
+    size_t group_begin = 0;
+    for (size_t group = 0; group < group_count; ++group) {
+        size_t group_end = std::upper_bound(priorities.begin(), priorities.end(),
+                                            NotificationPriority(group)) - priorities.begin();
+        auto notifiers = m_notifiers.data() + group_begin;
+        size_t count = group_end - group_begin;
+        group_begin = group_end;
+        if (count == 0) {
+            continue;
+        }
+        if (published) {
+            notify_realms();
+        }
+
+        // Update the fields that are actually read on other threads. This is
+        // always done in the group's order, regardless of which thread ran
+        // each notifier.
+        auto prepare_handover = [&] {
+            for (size_t i = 0; i < count; ++i) {
+                notifiers[i]->prepare_handover();
+            }
+        };
+
+        // Spread the group over the pool's threads if there's one
+        if (count > 1 && get_notifier_pool()) {
+            m_notifier_pool->run(*m_notifier_sg, notifiers, count, prepare_handover);
+        }
+        else {
+            for (size_t i = 0; i < count; ++i) {
+                notifiers[i]->run();
+            }
+            prepare_handover();
+        }
+
+        // The groups which haven't run yet are still at the previous version,
+        // and are skipped by deliver_notifiers() until they catch up
+        publish_delivery_state(version, nullptr);
+        published = true;
     }
 
-    // Reacquire the lock while updating the fields that are actually read on
-    // other threads
     lock.lock();
-    for (auto& notifier : notifiers) {
-        notifier->prepare_handover();
-    }
-    m_notifiers = std::move(notifiers);
     clean_up_dead_notifiers();
+    publish_delivery_state(version, nullptr);
+
+    // Commits made after the notifiers were advanced have to wait for the
+    // next run, and they can't be older than the start of this one
+    if (m_config.notification_rate_limit.min_interval.count() > 0 && m_notifier_sg
+        && m_notifier_sg->get_transact_stage() == SharedGroup::transact_Reading
+        && m_notifier_sg->has_changed()) {
+        std::lock_guard<std::mutex> rate_limit_lock(m_rate_limit_mutex);
+        if (!m_have_held_back_commit) {
+            m_first_held_back_commit = m_last_notifier_run;
+            m_have_held_back_commit = true;
+        }
+    }
+}
+
+void RealmCoordinator::publish_delivery_state(SharedGroup::VersionID version, std::exception_ptr error)
+{
+    if (m_notifiers.empty()) {
+        version = SharedGroup::VersionID{};
+    }
+
+    bool list_changed = !m_published_notifiers || *m_published_notifiers != m_notifiers;
+    if (list_changed) {
+        m_published_notifiers = std::make_shared<const NotifierList>(m_notifiers);
+    }
+    else {
+        auto state = m_delivery_state.load();
+        SharedGroup::VersionID published_version = state->version;
+        if (published_version == version && state->error == error) {
+            return;
+        }
+    }
+    m_delivery_state.exchange(std::make_shared<const DeliveryState>(DeliveryState{
+        m_published_notifiers, version, std::move(error), m_decoded_changesets}));
+}
+
+void RealmCoordinator::add_decoded_changeset(std::shared_ptr<const DecodedChangeset> changeset)
+{
+    // Keep the newest changesets which fit within the budget along with the
+    // new one. Published states may still be using the current list, so this
+    // always builds a new one.
+    size_t total_bytes = transaction::decoded_size(*changeset);
+    size_t keep = 0;
+    if (m_decoded_changesets) {
+        for (auto it = m_decoded_changesets->rbegin(); it != m_decoded_changesets->rend(); ++it) {
+            total_bytes += transaction::decoded_size(**it);
+            if (keep + 1 == max_decoded_changesets || total_bytes > max_decoded_bytes)
+                break;
+            ++keep;
+        }
+    }
+
+    auto changesets = std::make_shared<DecodedChangesets>();
+    changesets->reserve(keep + 1);
+    if (keep) {
+        changesets->assign(m_decoded_changesets->end() - keep, m_decoded_changesets->end());
+    }
+    changesets->push_back(std::move(changeset));
+    m_decoded_changesets = std::move(changesets);
+}
+
+NotifierPool* RealmCoordinator::get_notifier_pool()
+{
+    if (!m_notifier_pool) {
+        size_t thread_count = m_config.notifier_threads;
+        if (thread_count == 0)
+            thread_count = std::thread::hardware_concurrency();
+        if (thread_count < 2)
+            return nullptr;
+        m_notifier_pool = std::make_unique<NotifierPool>(m_config, thread_count);
+    }
+    return m_notifier_pool.get();
 }
 
 void RealmCoordinator::open_helper_shared_group()
@@ -525,27 +741,30 @@ void RealmCoordinator::open_helper_shared_group()
     }
 }
 
-void RealmCoordinator::advance_to_ready(Realm& realm)
+namespace {
+// Call the callbacks for each of the notifiers which had something to deliver,
+// telling the binding that they're coming
+void call_callbacks(Realm& realm, std::vector<std::shared_ptr<CollectionNotifier>> const& notifiers)
 {
-    decltype(m_notifiers) notifiers;
-
-    auto& sg = Realm::Internal::get_shared_group(realm);
-
-    auto get_notifier_version = [&] {
-        for (auto& notifier : m_notifiers) {
-            auto version = notifier->version();
-            if (version != SharedGroup::VersionID{}) {
-                return version;
-            }
-        }
-        return SharedGroup::VersionID{};
-    };
+    if (notifiers.empty())
+        return;
 
-    SharedGroup::VersionID version;
-    {
-        std::lock_guard<std::mutex> lock(m_notifier_mutex);
-        version = get_notifier_version();
+    auto binding_context = realm.m_binding_context.get();
+    if (binding_context)
+        binding_context->will_send_notifications();
+    for (auto& notifier : notifiers) {
+        notifier->call_callbacks();
     }
+    if (binding_context)
+        binding_context->did_send_notifications();
+}
+} // anonymous namespace
+
+void RealmCoordinator::advance_to_ready(Realm& realm)
+{
+    auto& sg = Realm::Internal::get_shared_group(realm);
+    auto state = m_delivery_state.load();
+    SharedGroup::VersionID version = state ? state->version : SharedGroup::VersionID{};
 
     // no async notifiers; just advance to latest
     if (version.version == std::numeric_limits<uint_fast64_t>::max()) {
@@ -561,46 +780,49 @@ void RealmCoordinator::advance_to_ready(Realm& realm)
     while (true) {
         // Advance to the ready version without holding any locks because it
         // may end up calling user code (in did_change() notifications)
-        transaction::advance(sg, realm.m_binding_context.get(), version);
+        transaction::advance(sg, realm.m_binding_context.get(), version, state->changesets.get());
 
-        // Reacquire the lock and recheck the notifier version, as the notifiers may
-        // have advanced to a later version while we didn't hold the lock. If
-        // so, we need to release the lock and re-advance
-        std::lock_guard<std::mutex> lock(m_notifier_mutex);
-        version = get_notifier_version();
+        // Recheck the notifier version, as the notifiers may have advanced to
+        // a later version while we were advancing. If so, we need to re-advance
+        state = m_delivery_state.load();
+        version = state->version;
         if (version.version == std::numeric_limits<uint_fast64_t>::max())
             return;
-        if (version != sg.get_version_of_current_transaction())
-            continue;
-
-        // Query version now matches the SG version, so we can deliver them
-        for (auto& notifier : m_notifiers) {
-            if (notifier->deliver(realm, sg, m_async_error)) {
-                notifiers.push_back(notifier);
-            }
-        }
-        break;
+        if (version == sg.get_version_of_current_transaction())
+            break;
     }
 
-    for (auto& notifier : notifiers) {
-        notifier->call_callbacks();
-    }
+    // Query version now matches the SG version, so we can deliver them
+    call_callbacks(realm, deliver_notifiers(realm, *state));
 }
 
 void RealmCoordinator::process_available_async(Realm& realm)
 {
+    if (auto state = m_delivery_state.load()) {
+        call_callbacks(realm, deliver_notifiers(realm, *state));
+    }
+}
+
+RealmCoordinator::NotifierList RealmCoordinator::deliver_notifiers(Realm& realm, DeliveryState const& state)
+{
+    // Each notifier checks that it was handed over at the Realm's version, so
+    // any which haven't caught up to the published version yet are skipped
     auto& sg = Realm::Internal::get_shared_group(realm);
-    decltype(m_notifiers) notifiers;
-    {
-        std::lock_guard<std::mutex> lock(m_notifier_mutex);
-        for (auto& notifier : m_notifiers) {
-            if (notifier->deliver(realm, sg, m_async_error)) {
-                notifiers.push_back(notifier);
-            }
+    NotifierList notifiers;
+    for (auto& notifier : *state.notifiers) {
+        if (notifier->deliver(realm, sg, state.error)) {
+            notifiers.push_back(notifier);
         }
     }
+    return notifiers;
+}
 
-    for (auto& notifier : notifiers) {
-        notifier->call_callbacks();
+ParallelQueryExecutor& RealmCoordinator::get_query_executor()
+{
+    std::lock_guard<std::mutex> lock(m_query_executor_mutex);
+    if (!m_query_executor) {
+        size_t thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+        m_query_executor = std::make_unique<ParallelQueryExecutor>(m_config, thread_count);
     }
+    return *m_query_executor;
 }
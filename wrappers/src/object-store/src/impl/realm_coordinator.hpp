@@ -19,8 +19,14 @@
 #ifndef REALM_COORDINATOR_HPP
 #define REALM_COORDINATOR_HPP
 
+#include "impl/transact_log_handler.hpp"
 #include "shared_realm.hpp"
+#include "util/atomic_shared_ptr.hpp"
 
+#include <realm/group_shared.hpp>
+
+#include <chrono>
+#include <condition_variable>
 #include <mutex>
 
 namespace realm {
@@ -32,6 +38,8 @@ class StringData;
 namespace _impl {
 class CollectionNotifier;
 class ExternalCommitHelper;
+class NotifierPool;
+class ParallelQueryExecutor;
 class WeakRealmNotifier;
 
 // RealmCoordinator manages the weak cache of Realm instances and communication
@@ -88,21 +96,58 @@ public:
     void advance_to_ready(Realm& realm);
     void process_available_async(Realm& realm);
 
+    // Get the worker pool used to evaluate queries in parallel, creating it on first use
+    ParallelQueryExecutor& get_query_executor();
+
 private:
     Realm::Config m_config;
 
     std::mutex m_realm_mutex;
     std::vector<WeakRealmNotifier> m_weak_realm_notifiers;
 
+    using NotifierList = std::vector<std::shared_ptr<_impl::CollectionNotifier>>;
+
+    // Guards m_new_notifiers, m_advancer_sg and m_async_error. It's only held by
+    // the worker while it advances newly registered notifiers, and is never
+    // needed to deliver notifications.
     std::mutex m_notifier_mutex;
-    std::vector<std::shared_ptr<_impl::CollectionNotifier>> m_new_notifiers;
-    std::vector<std::shared_ptr<_impl::CollectionNotifier>> m_notifiers;
+    NotifierList m_new_notifiers;
+
+    // The notifiers being run. Only used by run_async_notifiers(), so it's
+    // never touched by more than one thread at a time.
+    NotifierList m_notifiers;
+
+    // What the threads delivering notifications need, published by the worker
+    // as an immutable snapshot so that they can read it without taking a lock
+    // or waiting for the worker. The list of notifiers is only copied when the
+    // set of notifiers or their priority order changes, and otherwise each
+    // new version is published with the existing list.
+    struct DeliveryState {
+        std::shared_ptr<const NotifierList> notifiers;
+        // The newest version any of the notifiers have been handed over at,
+        // or the default VersionID if there are none
+        SharedGroup::VersionID version;
+        std::exception_ptr error;
+        // The changes the notifier SharedGroup has most recently advanced
+        // over, which Realms advancing to version replay rather than each
+        // parsing the same transaction logs again
+        std::shared_ptr<const DecodedChangesets> changesets;
+    };
+    util::AtomicSharedPtr<const DeliveryState> m_delivery_state;
+    // The list in the most recently published state. Only used by the worker.
+    std::shared_ptr<const NotifierList> m_published_notifiers;
+    // The changesets to publish with the next state. Only used by the worker.
+    std::shared_ptr<const DecodedChangesets> m_decoded_changesets;
 
     // SharedGroup used for actually running async notifiers
     // Will have a read transaction iff m_notifiers is non-empty
     std::unique_ptr<Replication> m_notifier_history;
     std::unique_ptr<SharedGroup> m_notifier_sg;
 
+    // Worker threads used to run the notifiers in parallel, if the Config
+    // asked for more than one thread. Only used by run_async_notifiers().
+    std::unique_ptr<_impl::NotifierPool> m_notifier_pool;
+
     // SharedGroup used to advance notifiers in m_new_notifiers to the main shared
     // group's transaction version
     // Will have a read transaction iff m_new_notifiers is non-empty
@@ -110,15 +155,51 @@ private:
     std::unique_ptr<SharedGroup> m_advancer_sg;
     std::exception_ptr m_async_error;
 
+    // When the notifiers were last run by on_change(), and a way to wake it
+    // up early if it's holding back a run when the coordinator is destroyed
+    std::mutex m_rate_limit_mutex;
+    std::condition_variable m_rate_limit_cv;
+    std::chrono::steady_clock::time_point m_last_notifier_run;
+    // When the oldest commit which hasn't been run yet was first seen, if any
+    std::chrono::steady_clock::time_point m_first_held_back_commit;
+    bool m_have_held_back_commit = false;
+    bool m_closing = false;
+
     std::unique_ptr<_impl::ExternalCommitHelper> m_notifier;
 
+    std::mutex m_query_executor_mutex;
+    std::unique_ptr<_impl::ParallelQueryExecutor> m_query_executor;
+
     // must be called with m_notifier_mutex locked
     void pin_version(uint_fast64_t version, uint_fast32_t index);
 
+    // Wait until the notifiers can be run again according to the Config's
+    // notification_rate_limit. Returns false if the coordinator is being
+    // destroyed and they shouldn't be run at all.
+    bool wait_for_rate_limit();
+    // Tell each of the Realms that there may be new notifications to deliver
+    void notify_realms();
     void run_async_notifiers();
     void open_helper_shared_group();
+    // Get the notifier pool, creating it on first use, or null if the
+    // notifiers should be run on the calling thread
+    _impl::NotifierPool* get_notifier_pool();
     void advance_helper_shared_group_to_latest();
     void clean_up_dead_notifiers();
+    // Deliver each of the notifiers in state for realm, returning the ones
+    // with callbacks to call
+    NotifierList deliver_notifiers(Realm& realm, DeliveryState const& state);
+    // Publish a new DeliveryState with the given version and error, copying
+    // m_notifiers only if it differs from the currently published list
+    void publish_delivery_state(SharedGroup::VersionID version, std::exception_ptr error);
+    // Add a changeset to the ones published with the next state, dropping the
+    // oldest once there's more than max_decoded_changesets or they take more
+    // than max_decoded_bytes between them. A single changeset over the byte
+    // budget isn't decoded at all. Realms which have fallen further behind
+    // than what's kept just parse the logs themselves.
+    void add_decoded_changeset(std::shared_ptr<const DecodedChangeset> changeset);
+    static constexpr size_t max_decoded_changesets = 16;
+    static constexpr size_t max_decoded_bytes = 4 * 1024 * 1024;
 };
 
 } // namespace _impl
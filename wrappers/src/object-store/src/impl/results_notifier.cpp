@@ -18,15 +18,239 @@
 
 #include "impl/results_notifier.hpp"
 
+#include "impl/limited_query.hpp"
 #include "results.hpp"
 
+#include <algorithm>
+
 using namespace realm;
 using namespace realm::_impl;
 
+namespace {
+// Updating the results incrementally evaluates the query separately for each
+// inserted or modified row, which is much slower per row than running it over
+// the whole table, so it's only done when at most 1/this of the table changed
+const size_t min_rows_per_changed_row = 16;
+
+// Orders rows the same way TableView::sort() does: by the sort columns with
+// nulls before all other values, and then by row index, as it's a stable sort
+// of the rows in table order
+class RowComparator {
+public:
+    RowComparator(Table const& table, SortOrder const& sort) : m_table(table), m_sort(sort) { }
+
+    // Core compares strings using its own collation rules, so only sorting on
+    // the other primitive types can be reproduced here
+    bool is_supported() const
+    {
+        for (auto col : m_sort.column_indices) {
+            switch (m_table.get_column_type(col)) {
+                case type_Int:
+                case type_Bool:
+                case type_Float:
+                case type_Double:
+                case type_DateTime:
+                    break;
+                default:
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator()(size_t a, size_t b) const
+    {
+        for (size_t i = 0; i < m_sort.column_indices.size(); ++i) {
+            int cmp = compare(m_sort.column_indices[i], a, b);
+            if (cmp != 0)
+                return m_sort.ascending[i] ? cmp < 0 : cmp > 0;
+        }
+        return a < b;
+    }
+
+private:
+    Table const& m_table;
+    SortOrder const& m_sort;
+
+    template<typename T>
+    static int compare_values(T a, T b)
+    {
+        return a < b ? -1 : b < a ? 1 : 0;
+    }
+
+    int compare(size_t col, size_t a, size_t b) const
+    {
+        bool a_is_null = m_table.is_null(col, a), b_is_null = m_table.is_null(col, b);
+        if (a_is_null || b_is_null)
+            return compare_values(!a_is_null, !b_is_null);
+
+        switch (m_table.get_column_type(col)) {
+            case type_Int:
+                return compare_values(m_table.get_int(col, a), m_table.get_int(col, b));
+            case type_Bool:
+                return compare_values(m_table.get_bool(col, a), m_table.get_bool(col, b));
+            case type_Float:
+                return compare_values(m_table.get_float(col, a), m_table.get_float(col, b));
+            case type_Double:
+                return compare_values(m_table.get_double(col, a), m_table.get_double(col, b));
+            case type_DateTime:
+                return compare_values(m_table.get_datetime(col, a).get_datetime(),
+                                      m_table.get_datetime(col, b).get_datetime());
+            default:
+                REALM_UNREACHABLE();
+        }
+    }
+};
+
+// Update the table-ordered `rows` for the candidate rows which were inserted or
+// modified, where matches(row) checks if a row matches the query
+template<typename Matches, typename DidChange>
+CollectionChangeBuilder update_unsorted_rows(std::vector<size_t>& rows, std::vector<size_t> const& candidates,
+                                             Matches&& matches, DidChange&& row_did_change)
+{
+    std::vector<size_t> next_rows;
+    next_rows.reserve(rows.size() + candidates.size());
+    std::copy_if(rows.begin(), rows.end(), std::back_inserter(next_rows),
+                 [](size_t row) { return row != npos; });
+    std::sort(next_rows.begin(), next_rows.end());
+
+    std::vector<size_t> added, removed;
+    for (size_t row : candidates) {
+        bool row_matches = matches(row);
+        bool present = std::binary_search(next_rows.begin(), next_rows.end(), row);
+        if (row_matches && !present)
+            added.push_back(row);
+        else if (!row_matches && present)
+            removed.push_back(row);
+    }
+
+    if (!removed.empty()) {
+        next_rows.erase(std::remove_if(next_rows.begin(), next_rows.end(), [&](size_t row) {
+            return std::binary_search(removed.begin(), removed.end(), row);
+        }), next_rows.end());
+    }
+    size_t previous_size = next_rows.size();
+    next_rows.insert(next_rows.end(), added.begin(), added.end());
+    std::inplace_merge(next_rows.begin(), next_rows.begin() + previous_size, next_rows.end());
+
+    auto changes = CollectionChangeBuilder::calculate(rows, next_rows, row_did_change, false);
+    rows = std::move(next_rows);
+    return changes;
+}
+
+// Update the sorted `rows` for the candidate rows by removing each of them and
+// then inserting the ones which still match at the position found by a binary
+// search, rather than re-sorting all of the rows. Rows which end up in a
+// different position relative to the rows which weren't touched are reported
+// as moves.
+template<typename Matches, typename DidChange>
+CollectionChangeBuilder update_sorted_rows(std::vector<size_t>& rows, std::vector<size_t> const& candidates,
+                                           Matches&& matches, DidChange&& row_did_change,
+                                           RowComparator const& less)
+{
+    struct Candidate {
+        size_t row;
+        // Index in the old and new rows, or npos if not present
+        size_t old_ndx, new_ndx;
+        // The number of untouched rows before this one, and this row's position
+        // among the other candidates which have the same number before them
+        size_t old_gap, new_gap;
+        size_t old_rank, new_rank;
+    };
+
+    CollectionChangeBuilder changes;
+
+    // Split the old rows into the ones which can't have changed position and
+    // the candidates, which are removed until their new position is known
+    std::vector<size_t> kept;
+    std::vector<Candidate> previous;
+    kept.reserve(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        size_t row = rows[i];
+        if (row == npos)
+            changes.deletions.add(i);
+        else if (std::binary_search(candidates.begin(), candidates.end(), row))
+            previous.push_back({row, i, npos, kept.size(), npos, 0, 0});
+        else
+            kept.push_back(row);
+    }
+    std::sort(previous.begin(), previous.end(), [](auto const& a, auto const& b) { return a.row < b.row; });
+
+    std::vector<Candidate> next;
+    next.reserve(candidates.size());
+    for (size_t row : candidates) {
+        auto it = std::lower_bound(previous.begin(), previous.end(), row,
+                                   [](auto const& c, size_t row) { return c.row < row; });
+        bool was_present = it != previous.end() && it->row == row;
+        if (!matches(row)) {
+            if (was_present)
+                changes.deletions.add(it->old_ndx);
+            continue;
+        }
+
+        Candidate c = was_present ? *it : Candidate{row, npos, npos, npos, npos, 0, 0};
+        c.new_gap = std::lower_bound(kept.begin(), kept.end(), row, less) - kept.begin();
+        next.push_back(c);
+    }
+
+    std::sort(next.begin(), next.end(), [&](auto const& a, auto const& b) {
+        return a.new_gap != b.new_gap ? a.new_gap < b.new_gap : less(a.row, b.row);
+    });
+
+    // A row which was present before and after is left in place if it has
+    // the same untouched rows before it and the same order relative to the
+    // other such rows in that gap. Insertions and deletions don't count.
+    std::vector<Candidate*> remaining;
+    for (size_t i = 0; i < next.size(); ++i) {
+        next[i].new_ndx = next[i].new_gap + i;
+        if (next[i].old_ndx != npos)
+            remaining.push_back(&next[i]);
+    }
+    for (size_t i = 0; i < remaining.size(); ++i) {
+        bool same_gap = i > 0 && remaining[i]->new_gap == remaining[i - 1]->new_gap;
+        remaining[i]->new_rank = same_gap ? remaining[i - 1]->new_rank + 1 : 0;
+    }
+    std::sort(remaining.begin(), remaining.end(), [](auto a, auto b) { return a->old_ndx < b->old_ndx; });
+    for (size_t i = 0; i < remaining.size(); ++i) {
+        bool same_gap = i > 0 && remaining[i]->old_gap == remaining[i - 1]->old_gap;
+        remaining[i]->old_rank = same_gap ? remaining[i - 1]->old_rank + 1 : 0;
+    }
+
+    std::vector<size_t> next_rows;
+    next_rows.reserve(kept.size() + next.size());
+    auto kept_it = kept.begin();
+    for (auto const& c : next) {
+        next_rows.insert(next_rows.end(), kept_it, kept.begin() + c.new_gap);
+        kept_it = kept.begin() + c.new_gap;
+        next_rows.push_back(c.row);
+
+        if (c.old_ndx == npos) {
+            changes.insertions.add(c.new_ndx);
+            continue;
+        }
+        if (c.old_gap != c.new_gap || c.old_rank != c.new_rank) {
+            changes.deletions.add(c.old_ndx);
+            changes.insertions.add(c.new_ndx);
+            changes.moves.push_back({c.old_ndx, c.new_ndx});
+        }
+        if (row_did_change(c.row))
+            changes.modifications.add(c.new_ndx);
+    }
+    next_rows.insert(next_rows.end(), kept_it, kept.end());
+
+    std::sort(changes.moves.begin(), changes.moves.end(),
+              [](auto const& a, auto const& b) { return a.from < b.from; });
+    rows = std::move(next_rows);
+    return changes;
+}
+}
+
 ResultsNotifier::ResultsNotifier(Results& target)
 : CollectionNotifier(target.get_realm())
 , m_target_results(&target)
 , m_sort(target.get_sort())
+, m_offset(target.get_offset())
+, m_limit(target.get_limit())
 , m_from_linkview(target.get_linkview().get() != nullptr)
 {
     Query q = target.get_query();
@@ -81,7 +305,9 @@ bool ResultsNotifier::need_to_run()
     {
         auto lock = lock_target();
         // Don't run the query if the results aren't actually going to be used
-        if (!get_realm() || (!have_callbacks() && !m_target_results->wants_background_updates())) {
+        m_wants_table_view = m_target_results->wants_background_updates();
+        if (!get_realm() || (!have_callbacks() && !m_wants_table_view)) {
+            m_previous_rows_current = false;
             return false;
         }
     }
@@ -98,30 +324,40 @@ bool ResultsNotifier::need_to_run()
     return true;
 }
 
+// Update the row indices in m_previous_rows for the rows moved by `changes`,
+// and replace deleted ones with npos
+void ResultsNotifier::map_previous_rows(CollectionChangeBuilder const& changes)
+{
+    auto const& moves = changes.moves;
+    for (auto& idx : m_previous_rows) {
+        auto it = lower_bound(begin(moves), end(moves), idx,
+                              [](auto const& a, auto b) { return a.from < b; });
+        if (it != moves.end() && it->from == idx)
+            idx = it->to;
+        else if (changes.deletions.contains(idx))
+            idx = npos;
+        else
+            REALM_ASSERT_DEBUG(!changes.insertions.contains(idx));
+    }
+}
+
 void ResultsNotifier::calculate_changes()
 {
+    // Only the rows in the window are diffed, even though m_tv can contain
+    // the rows before it and rows after the limit
+    const size_t end = m_limit < m_tv.size() - std::min(m_offset, m_tv.size()) ? m_offset + m_limit : m_tv.size();
+    const size_t begin = std::min(m_offset, end);
     size_t table_ndx = m_query->get_table()->get_index_in_group();
     if (m_initial_run_complete) {
         auto changes = table_ndx < m_info->tables.size() ? &m_info->tables[table_ndx] : nullptr;
 
         std::vector<size_t> next_rows;
-        next_rows.reserve(m_tv.size());
-        for (size_t i = 0; i < m_tv.size(); ++i)
+        next_rows.reserve(end - begin);
+        for (size_t i = begin; i < end; ++i)
             next_rows.push_back(m_tv[i].get_index());
 
-        if (changes) {
-            auto const& moves = changes->moves;
-            for (auto& idx : m_previous_rows) {
-                auto it = lower_bound(begin(moves), end(moves), idx,
-                                      [](auto const& a, auto b) { return a.from < b; });
-                if (it != moves.end() && it->from == idx)
-                    idx = it->to;
-                else if (changes->deletions.contains(idx))
-                    idx = npos;
-                else
-                    REALM_ASSERT_DEBUG(!changes->insertions.contains(idx));
-            }
-        }
+        if (changes)
+            map_previous_rows(*changes);
 
         m_changes = CollectionChangeBuilder::calculate(m_previous_rows, next_rows,
                                                        [&](size_t row) { return m_info->row_did_change(*m_query->get_table(), row); },
@@ -130,10 +366,80 @@ void ResultsNotifier::calculate_changes()
         m_previous_rows = std::move(next_rows);
     }
     else {
-        m_previous_rows.resize(m_tv.size());
-        for (size_t i = 0; i < m_tv.size(); ++i)
-            m_previous_rows[i] = m_tv[i].get_index();
+        m_previous_rows.resize(end - begin);
+        for (size_t i = begin; i < end; ++i)
+            m_previous_rows[i - begin] = m_tv[i].get_index();
     }
+    m_previous_rows_current = true;
+}
+
+// Rather than rerunning (and re-sorting) the query over the whole table,
+// re-evaluate it for only the rows which were inserted or modified and splice
+// the result into the previous rows. Core can't build a TableView from a list
+// of rows, so this is only used while the target Results isn't using the
+// TableViews it's sent. Returns false if the results have to be updated by
+// running the query normally.
+bool ResultsNotifier::run_incrementally()
+{
+    // The rows in a LinkView aren't in table order, so only queries on tables
+    // are updated incrementally, and windowed results would need rows from
+    // outside the window to replace the ones which were removed
+    if (!m_initial_run_complete || !m_previous_rows_current || m_from_linkview
+        || m_offset != 0 || m_limit != size_t(-1))
+        return false;
+
+    auto& table = *m_query->get_table();
+    RowComparator less(table, m_sort);
+    if (m_sort && !less.is_supported())
+        return false;
+
+    size_t table_ndx = table.get_index_in_group();
+    if (table_ndx >= m_info->tables.size())
+        return false;
+
+    // The query can only depend on rows other than the one being evaluated
+    // through links, and modifications to those aren't tracked per row here
+    for (size_t i = 0, count = table.get_column_count(); i < count; ++i) {
+        auto type = table.get_column_type(i);
+        if (type == type_Link || type == type_LinkList || type == type_Table)
+            return false;
+    }
+
+    auto const& changes = m_info->tables[table_ndx];
+    const size_t table_size = table.size();
+    const size_t inserted = changes.insertions.count();
+    const size_t modified = changes.modifications.count();
+    if ((inserted + modified) * min_rows_per_changed_row > table_size)
+        return false;
+    // Only rows added to the end of the table are handled, as inserting rows
+    // anywhere else would shift the existing rows
+    if (inserted && changes.insertions.begin()->first < table_size - inserted)
+        return false;
+
+    map_previous_rows(changes);
+
+    // Rows moved by move_last_over() keep their values, but are candidates for
+    // changing position in sorted results as ties are ordered by row index
+    std::vector<size_t> candidates;
+    candidates.reserve(inserted + modified + changes.moves.size());
+    std::merge(changes.insertions.as_indexes().begin(), changes.insertions.as_indexes().end(),
+               changes.modifications.as_indexes().begin(), changes.modifications.as_indexes().end(),
+               std::back_inserter(candidates));
+    for (auto const& move : changes.moves)
+        candidates.push_back(move.to);
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    auto matches = [&](size_t row) { return m_query->count(row, row + 1, 1) != 0; };
+    auto row_did_change = [&](size_t row) { return m_info->row_did_change(table, row); };
+    if (m_sort)
+        m_changes = update_sorted_rows(m_previous_rows, candidates, matches, row_did_change, less);
+    else
+        m_changes = update_unsorted_rows(m_previous_rows, candidates, matches, row_did_change);
+
+    m_last_seen_version = m_query->find_all(0, 0, 0).sync_if_needed();
+    m_ran_incrementally = true;
+    return true;
 }
 
 void ResultsNotifier::run()
@@ -141,9 +447,17 @@ void ResultsNotifier::run()
     if (!need_to_run())
         return;
 
-    m_tv = m_query->find_all();
-    if (m_sort) {
-        m_tv.sort(m_sort.column_indices, m_sort.ascending);
+    if (!m_wants_table_view && run_incrementally())
+        return;
+
+    if (m_limit != size_t(-1)) {
+        m_tv = find_all_limited(*m_query, m_sort, m_limit < size_t(-1) - m_offset ? m_offset + m_limit : size_t(-1));
+    }
+    else {
+        m_tv = m_query->find_all();
+        if (m_sort) {
+            m_tv.sort(m_sort.column_indices, m_sort.ascending);
+        }
     }
     m_last_seen_version = m_tv.sync_if_needed();
 
@@ -152,6 +466,13 @@ void ResultsNotifier::run()
 
 void ResultsNotifier::do_prepare_handover(SharedGroup& sg)
 {
+    if (m_ran_incrementally) {
+        m_ran_incrementally = false;
+        add_changes(std::move(m_changes));
+        REALM_ASSERT(m_changes.empty());
+        return;
+    }
+
     if (!m_tv.is_attached()) {
         return;
     }
@@ -194,6 +515,9 @@ bool ResultsNotifier::do_deliver(SharedGroup& sg)
         Results::Internal::set_table_view(*m_target_results,
                                           std::move(*sg.import_from_handover(std::move(m_tv_handover))));
     }
+    else {
+        Results::Internal::keep_table_view(*m_target_results);
+    }
     REALM_ASSERT(!m_tv_handover);
     return true;
 }
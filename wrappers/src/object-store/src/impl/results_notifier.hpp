@@ -36,6 +36,10 @@ private:
     Results* m_target_results;
 
     const SortOrder m_sort;
+    // Only the m_limit rows (or all of them if it's -1) starting at m_offset
+    // are tracked, and changes are reported relative to m_offset
+    const size_t m_offset;
+    const size_t m_limit;
     bool m_from_linkview;
 
     // The source Query, in handover form iff m_sg is null
@@ -62,8 +66,18 @@ private:
     // can lead to deliver() being called before that
     bool m_initial_run_complete = false;
 
+    // Does the target Results want a new TableView from the next run? If not,
+    // run() may update m_previous_rows and m_changes incrementally instead
+    bool m_wants_table_view = true;
+    // Did the last run() update the results incrementally, producing changes but no TableView?
+    bool m_ran_incrementally = false;
+    // Was m_previous_rows updated for every version since it was last calculated from a TableView?
+    bool m_previous_rows_current = false;
+
     bool need_to_run();
     void calculate_changes();
+    bool run_incrementally();
+    void map_previous_rows(CollectionChangeBuilder const& changes);
 
     void run() override;
     void do_prepare_handover(SharedGroup&) override;
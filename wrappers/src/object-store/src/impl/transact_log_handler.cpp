@@ -25,8 +25,62 @@
 #include <realm/group_shared.hpp>
 #include <realm/lang_bind_helper.hpp>
 
+#include <algorithm>
+
 using namespace realm;
 
+namespace realm {
+namespace _impl {
+struct DecodedChangeset {
+    enum class Op : uint8_t {
+        Modify,
+        SelectTable,
+        SelectDescriptor,
+        SelectLinkList,
+        InsertGroupLevelTable,
+        EraseGroupLevelTable,
+        RenameGroupLevelTable,
+        MoveGroupLevelTable,
+        InsertColumn,
+        InsertLinkColumn,
+        EraseColumn,
+        EraseLinkColumn,
+        RenameColumn,
+        MoveColumn,
+        SetLinkType,
+        AddSearchIndex,
+        RemoveSearchIndex,
+        InsertEmptyRows,
+        EraseRows,
+        SwapRows,
+        ClearTable,
+        OptimizeTable,
+        ChangeLinkTargets,
+        LinkListSet,
+        LinkListInsert,
+        LinkListErase,
+        LinkListNullify,
+        LinkListClear,
+        LinkListMove,
+        LinkListSwap,
+    };
+
+    struct Instruction {
+        Op op;
+        // The instruction's bool or small enum argument, if any
+        uint8_t flag;
+        size_t args[3];
+    };
+
+    uint_fast64_t from_version;
+    uint_fast64_t to_version;
+    std::vector<Instruction> instructions;
+    // Set if there's anything which the schema validation needs to look at
+    bool schema_changed = false;
+};
+} // namespace _impl
+} // namespace realm
+
 namespace {
 template<typename Derived>
 struct MarkDirtyMixin  {
@@ -565,16 +619,216 @@ public:
         return true;
     }
 };
+
+// Pass a single decoded instruction to one of the transaction log handlers
+// above. Values and names which none of them use aren't stored, so they're
+// passed as empty values.
+template<typename Handler>
+bool replay_instruction(_impl::DecodedChangeset::Instruction const& instr, Handler& handler)
+{
+    using Op = _impl::DecodedChangeset::Op;
+    auto a = instr.args;
+    switch (instr.op) {
+        case Op::Modify: handler.mark_dirty(a[0], a[1]); return true;
+        case Op::SelectTable: return handler.select_table(a[0], 0, nullptr);
+        case Op::SelectDescriptor: return handler.select_descriptor(int(a[0]), nullptr);
+        case Op::SelectLinkList: return handler.select_link_list(a[0], a[1], a[2]);
+        case Op::InsertGroupLevelTable: return handler.insert_group_level_table(a[0], a[1], StringData());
+        case Op::EraseGroupLevelTable: return handler.erase_group_level_table(a[0], a[1]);
+        case Op::RenameGroupLevelTable: return handler.rename_group_level_table(a[0], StringData());
+        case Op::MoveGroupLevelTable: return handler.move_group_level_table(a[0], a[1]);
+        case Op::InsertColumn: return handler.insert_column(a[0], DataType(a[1]), StringData(), instr.flag);
+        case Op::InsertLinkColumn: return handler.insert_link_column(a[0], DataType(instr.flag), StringData(), a[1], a[2]);
+        case Op::EraseColumn: return handler.erase_column(a[0]);
+        case Op::EraseLinkColumn: return handler.erase_link_column(a[0], a[1], a[2]);
+        case Op::RenameColumn: return handler.rename_column(a[0], StringData());
+        case Op::MoveColumn: return handler.move_column(a[0], a[1]);
+        case Op::SetLinkType: return handler.set_link_type(a[0], LinkType(instr.flag));
+        case Op::AddSearchIndex: return handler.add_search_index(a[0]);
+        case Op::RemoveSearchIndex: return handler.remove_search_index(a[0]);
+        case Op::InsertEmptyRows: return handler.insert_empty_rows(a[0], a[1], a[2], instr.flag);
+        case Op::EraseRows: return handler.erase_rows(a[0], a[1], a[2], instr.flag);
+        case Op::SwapRows: return handler.swap_rows(a[0], a[1]);
+        case Op::ClearTable: return handler.clear_table();
+        case Op::OptimizeTable: return handler.optimize_table();
+        case Op::ChangeLinkTargets: return handler.change_link_targets(a[0], a[1]);
+        case Op::LinkListSet: return handler.link_list_set(a[0], a[1]);
+        case Op::LinkListInsert: return handler.link_list_insert(a[0], a[1]);
+        case Op::LinkListErase: return handler.link_list_erase(a[0]);
+        case Op::LinkListNullify: return handler.link_list_nullify(a[0]);
+        case Op::LinkListClear: return handler.link_list_clear(a[0]);
+        case Op::LinkListMove: return handler.link_list_move(a[0], a[1]);
+        case Op::LinkListSwap: return handler.link_list_swap(a[0], a[1]);
+    }
+    REALM_UNREACHABLE();
+}
+
+template<typename Handler>
+void replay_changeset(_impl::DecodedChangeset const& changeset, Handler& handler)
+{
+    for (auto const& instr : changeset.instructions) {
+        // The only thing the handlers reject is subtables, which the object
+        // store never creates
+        if (!replay_instruction(instr, handler))
+            throw std::runtime_error("Unsupported instruction in transaction log");
+    }
+}
+
+// Records everything which the handlers above look at into a DecodedChangeset,
+// and passes each instruction on to observer (if non-null) as it goes so that
+// the logs are still only parsed once. Recording is abandoned if the changeset
+// would use more than max_bytes, as a bulk write can decode to far more than
+// it's worth keeping around, and the logs are then parsed as normal instead.
+template<typename Observer>
+class ChangesetRecorder : public MarkDirtyMixin<ChangesetRecorder<Observer>> {
+    using Op = _impl::DecodedChangeset::Op;
+    using Instruction = _impl::DecodedChangeset::Instruction;
+    _impl::DecodedChangeset m_changeset;
+    Observer* m_observer;
+    size_t m_max_instructions;
+    bool m_recording = true;
+
+    bool add(Op op, size_t a = 0, size_t b = 0, size_t c = 0, uint8_t flag = 0)
+    {
+        Instruction instr{op, flag, {a, b, c}};
+        if (m_recording) {
+            if (m_changeset.instructions.size() < m_max_instructions) {
+                m_changeset.instructions.push_back(instr);
+            }
+            else {
+                m_recording = false;
+                std::vector<Instruction>().swap(m_changeset.instructions);
+            }
+        }
+        return !m_observer || replay_instruction(instr, *m_observer);
+    }
+
+    bool add_schema_change(Op op, size_t a = 0, size_t b = 0, size_t c = 0, uint8_t flag = 0)
+    {
+        m_changeset.schema_changed = true;
+        return add(op, a, b, c, flag);
+    }
+
+public:
+    ChangesetRecorder(uint_fast64_t from_version, Observer* observer, size_t max_bytes)
+    : m_observer(observer)
+    , m_max_instructions(max_bytes / sizeof(Instruction))
+    {
+        m_changeset.from_version = from_version;
+    }
+
+    // Returns null if there were no changes or they were too large to record
+    std::shared_ptr<const _impl::DecodedChangeset> finish(uint_fast64_t to_version)
+    {
+        if (!m_recording || to_version == m_changeset.from_version)
+            return nullptr;
+        m_changeset.to_version = to_version;
+        m_changeset.instructions.shrink_to_fit();
+        return std::make_shared<_impl::DecodedChangeset>(std::move(m_changeset));
+    }
+
+    void mark_dirty(size_t row, size_t col) { add(Op::Modify, row, col); }
+    void parse_complete()
+    {
+        if (m_observer)
+            m_observer->parse_complete();
+    }
+
+    bool select_table(size_t group_level_ndx, int, const size_t*) { return add(Op::SelectTable, group_level_ndx); }
+    bool select_descriptor(int levels, const size_t*) { return add_schema_change(Op::SelectDescriptor, levels); }
+    bool select_link_list(size_t col, size_t row, size_t target) { return add(Op::SelectLinkList, col, row, target); }
+
+    bool insert_group_level_table(size_t table_ndx, size_t prior_size, StringData) { return add_schema_change(Op::InsertGroupLevelTable, table_ndx, prior_size); }
+    bool erase_group_level_table(size_t table_ndx, size_t prior_size) { return add_schema_change(Op::EraseGroupLevelTable, table_ndx, prior_size); }
+    bool rename_group_level_table(size_t table_ndx, StringData) { return add_schema_change(Op::RenameGroupLevelTable, table_ndx); }
+    bool move_group_level_table(size_t from, size_t to) { return add_schema_change(Op::MoveGroupLevelTable, from, to); }
+    bool insert_column(size_t col, DataType type, StringData, bool nullable) { return add_schema_change(Op::InsertColumn, col, type, 0, nullable); }
+    bool insert_link_column(size_t col, DataType type, StringData, size_t target, size_t backlink_col) { return add_schema_change(Op::InsertLinkColumn, col, target, backlink_col, type); }
+    bool erase_column(size_t col) { return add_schema_change(Op::EraseColumn, col); }
+    bool erase_link_column(size_t col, size_t target, size_t backlink_col) { return add_schema_change(Op::EraseLinkColumn, col, target, backlink_col); }
+    bool rename_column(size_t col, StringData) { return add_schema_change(Op::RenameColumn, col); }
+    bool move_column(size_t from, size_t to) { return add_schema_change(Op::MoveColumn, from, to); }
+    bool set_link_type(size_t col, LinkType type) { return add_schema_change(Op::SetLinkType, col, 0, 0, type); }
+    bool add_search_index(size_t col) { return add_schema_change(Op::AddSearchIndex, col); }
+    bool remove_search_index(size_t col) { return add_schema_change(Op::RemoveSearchIndex, col); }
+
+    bool insert_empty_rows(size_t row, size_t count, size_t prior_size, bool unordered) { return add(Op::InsertEmptyRows, row, count, prior_size, unordered); }
+    bool erase_rows(size_t row, size_t count, size_t prior_size, bool unordered) { return add(Op::EraseRows, row, count, prior_size, unordered); }
+    bool swap_rows(size_t row1, size_t row2) { return add(Op::SwapRows, row1, row2); }
+    bool clear_table() { return add(Op::ClearTable); }
+    bool optimize_table() { return add(Op::OptimizeTable); }
+    bool change_link_targets(size_t row, size_t new_row) { return add(Op::ChangeLinkTargets, row, new_row); }
+
+    bool link_list_set(size_t index, size_t value) { return add(Op::LinkListSet, index, value); }
+    bool link_list_insert(size_t index, size_t value) { return add(Op::LinkListInsert, index, value); }
+    bool link_list_erase(size_t index) { return add(Op::LinkListErase, index); }
+    bool link_list_nullify(size_t index) { return add(Op::LinkListNullify, index); }
+    bool link_list_clear(size_t old_size) { return add(Op::LinkListClear, old_size); }
+    bool link_list_move(size_t from, size_t to) { return add(Op::LinkListMove, from, to); }
+    bool link_list_swap(size_t index1, size_t index2) { return add(Op::LinkListSwap, index1, index2); }
+};
+
+using ChangesetChain = std::vector<_impl::DecodedChangeset const*>;
+
+// Called with no handler when there's nothing observing the changes
+void replay_changesets(ChangesetChain const&) { }
+
+template<typename Handler>
+void replay_changesets(ChangesetChain const& chain, Handler& handler)
+{
+    for (auto changeset : chain)
+        replay_changeset(*changeset, handler);
+    handler.parse_complete();
+}
+
+// Get the run of decoded changesets which covers exactly the versions from
+// `from` to `to`, or an empty chain if there isn't one
+ChangesetChain find_changesets(_impl::DecodedChangesets const* changesets,
+                               uint_fast64_t from, uint_fast64_t to)
+{
+    ChangesetChain chain;
+    if (!changesets || from >= to || to == std::numeric_limits<uint_fast64_t>::max())
+        return chain;
+
+    for (auto const& changeset : *changesets) {
+        if (changeset->from_version < from)
+            continue;
+        if (changeset->from_version > from)
+            break;
+        chain.push_back(changeset.get());
+        from = changeset->to_version;
+        if (from == to)
+            return chain;
+    }
+    chain.clear();
+    return chain;
+}
 } // anonymous namespace
 
 namespace realm {
 namespace _impl {
 namespace transaction {
-void advance(SharedGroup& sg, BindingContext* context, SharedGroup::VersionID version)
+void advance(SharedGroup& sg, BindingContext* context, SharedGroup::VersionID version,
+             DecodedChangesets const* changesets)
 {
-    TransactLogObserver(context, sg, [&](auto&&... args) {
-        LangBindHelper::advance_read(sg, std::move(args)..., version);
-    }, true);
+    auto chain = find_changesets(changesets, sg.get_version_of_current_transaction().version, version.version);
+    if (chain.empty()) {
+        TransactLogObserver(context, sg, [&](auto&&... args) {
+            LangBindHelper::advance_read(sg, std::move(args)..., version);
+        }, true);
+        return;
+    }
+
+    // advance_read() parses the logs a second time for the observer, so
+    // replaying the decoded changes instead leaves just the parse which
+    // updates the accessors. There's nothing to validate if none of the
+    // changes touched the schema.
+    bool schema_changed = std::any_of(chain.begin(), chain.end(),
+                                      [](auto changeset) { return changeset->schema_changed; });
+    TransactLogObserver(context, sg, [&](auto&&... observer) {
+        replay_changesets(chain, observer...);
+        LangBindHelper::advance_read(sg, version);
+    }, schema_changed);
 }
 
 void begin(SharedGroup& sg, BindingContext* context, bool validate_schema_changes)
@@ -602,15 +856,43 @@ void cancel(SharedGroup& sg, BindingContext* context)
 
 void advance(SharedGroup& sg,
              TransactionChangeInfo& info,
-             SharedGroup::VersionID version)
+             SharedGroup::VersionID version,
+             DecodedChangesets const* changesets)
 {
     if (info.table_modifications_needed.empty() && info.lists.empty()) {
         LangBindHelper::advance_read(sg, version);
+        return;
     }
-    else {
+
+    auto chain = find_changesets(changesets, sg.get_version_of_current_transaction().version, version.version);
+    if (chain.empty()) {
         LangBindHelper::advance_read(sg, LinkViewObserver(info), version);
     }
+    else {
+        LinkViewObserver observer(info);
+        replay_changesets(chain, observer);
+        LangBindHelper::advance_read(sg, version);
+    }
+}
+
+std::shared_ptr<const DecodedChangeset> advance_and_decode(SharedGroup& sg,
+                                                           TransactionChangeInfo* info,
+                                                           SharedGroup::VersionID version,
+                                                           size_t max_bytes)
+{
+    std::unique_ptr<LinkViewObserver> observer;
+    if (info && (!info->table_modifications_needed.empty() || !info->lists.empty()))
+        observer = std::make_unique<LinkViewObserver>(*info);
+
+    ChangesetRecorder<LinkViewObserver> recorder(sg.get_version_of_current_transaction().version,
+                                                 observer.get(), max_bytes);
+    LangBindHelper::advance_read(sg, recorder, version);
+    return recorder.finish(sg.get_version_of_current_transaction().version);
+}
 
+size_t decoded_size(DecodedChangeset const& changeset)
+{
+    return sizeof(changeset) + changeset.instructions.capacity() * sizeof(DecodedChangeset::Instruction);
 }
 
 } // namespace transaction
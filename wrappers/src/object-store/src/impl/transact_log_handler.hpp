@@ -21,17 +21,30 @@
 
 #include <realm/group_shared.hpp>
 
+#include <memory>
+#include <vector>
+
 namespace realm {
 class BindingContext;
 
 namespace _impl {
 struct TransactionChangeInfo;
 
+// The changes between two versions in an already-parsed compact form, which
+// can be replayed into the transaction log observers instead of parsing the
+// transaction logs again
+struct DecodedChangeset;
+// Decoded changesets in version order
+using DecodedChangesets = std::vector<std::shared_ptr<const DecodedChangeset>>;
+
 namespace transaction {
 // Advance the read transaction version, with change notifications sent to delegate
 // Must not be called from within a write transaction.
+// If version is given and changesets has a run of decoded changesets from the
+// current version to it, they are replayed rather than parsing the logs again.
 void advance(SharedGroup& sg, BindingContext* binding_context,
-             SharedGroup::VersionID version=SharedGroup::VersionID{});
+             SharedGroup::VersionID version=SharedGroup::VersionID{},
+             DecodedChangesets const* changesets=nullptr);
 
 // Begin a write transaction
 // If the read transaction version is not up to date, will first advance to the
@@ -49,7 +62,20 @@ void cancel(SharedGroup& sg, BindingContext* binding_context);
 // Advance the read transaction version, with change information gathered in info
 void advance(SharedGroup& sg,
              TransactionChangeInfo& info,
-             SharedGroup::VersionID version=SharedGroup::VersionID{});
+             SharedGroup::VersionID version=SharedGroup::VersionID{},
+             DecodedChangesets const* changesets=nullptr);
+
+// Advance the read transaction version, with change information gathered in
+// info if it's non-null, and return the changes which were advanced over so
+// that they can be replayed by other SharedGroups. Returns null if there were
+// no changes, or if decoding them would take more than max_bytes.
+std::shared_ptr<const DecodedChangeset> advance_and_decode(SharedGroup& sg,
+                                                           TransactionChangeInfo* info,
+                                                           SharedGroup::VersionID version,
+                                                           size_t max_bytes);
+
+// The memory used by a decoded changeset, in bytes
+size_t decoded_size(DecodedChangeset const& changeset);
 } // namespace transaction
 } // namespace _impl
 } // namespace realm
@@ -136,6 +136,11 @@ public:
     using ChunkedRangeVector::end;
     using ChunkedRangeVector::empty;
     using ChunkedRangeVector::verify;
+    using ChunkedRangeVector::Chunk;
+
+    // The chunks the ranges are stored in, each of which holds a contiguous array
+    // of ranges, for reading the set without iterating over it a range at a time
+    std::vector<Chunk> const& chunks() const { return m_data; }
 
     IndexSet() = default;
     IndexSet(std::initializer_list<size_t>);
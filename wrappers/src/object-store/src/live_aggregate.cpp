@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "live_aggregate.hpp"
+
+#include "impl/aggregate_notifier.hpp"
+#include "impl/realm_coordinator.hpp"
+#include "results.hpp"
+
+using namespace realm;
+using namespace realm::_impl;
+
+LiveAggregate::LiveAggregate(Results const& results, size_t column)
+: m_column(column)
+{
+    Query q = results.get_query();
+    auto table = q.get_table();
+    if (!table)
+        return;
+
+    if (column >= table->get_column_count())
+        throw Results::OutOfBoundsIndexException{column, table->get_column_count()};
+    switch (table->get_column_type(column)) {
+        case type_Int:
+        case type_Float:
+        case type_Double:
+        case type_DateTime:
+            break;
+        default:
+            throw Results::UnsupportedColumnTypeException{column, table.get()};
+    }
+
+    auto realm = results.get_realm();
+    if (realm->config().read_only) {
+        throw InvalidTransactionException("Cannot create asynchronous query for read-only Realms");
+    }
+    if (realm->is_in_transaction()) {
+        throw InvalidTransactionException("Cannot create asynchronous query while in a write transaction");
+    }
+
+    m_notifier = std::make_shared<AggregateNotifier>(results, column);
+    RealmCoordinator::register_notifier(m_notifier);
+}
+
+LiveAggregate::~LiveAggregate()
+{
+    if (m_notifier) {
+        m_notifier->unregister();
+    }
+}
+
+util::Optional<LiveAggregate::Values> LiveAggregate::get_values() const
+{
+    if (!m_notifier)
+        return Values{};
+    return m_notifier->get_values();
+}
+
+NotificationToken LiveAggregate::add_notification_callback(Callback callback)
+{
+    if (!m_notifier)
+        return {};
+
+    // The notifier owns the callback, so it can't hold a strong reference to it
+    auto notifier = m_notifier.get();
+    return {m_notifier, m_notifier->add_callback([=](CollectionChangeSet, std::exception_ptr err) {
+        callback(err ? Values{} : *notifier->get_values(), err);
+    })};
+}
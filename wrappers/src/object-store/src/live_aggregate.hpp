@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef REALM_LIVE_AGGREGATE_HPP
+#define REALM_LIVE_AGGREGATE_HPP
+
+#include "collection_notifications.hpp"
+
+#include <realm/mixed.hpp>
+#include <realm/util/optional.hpp>
+
+#include <functional>
+#include <memory>
+
+namespace realm {
+class Results;
+
+namespace _impl {
+    class AggregateNotifier;
+}
+
+// The count, min, max, sum and average of one column of a Results, kept up to
+// date on the background worker thread as the Realm changes. When possible
+// they are updated from only the rows which were inserted, modified or deleted
+// by each transaction rather than from all of the rows.
+class LiveAggregate {
+public:
+    struct Values {
+        // Number of non-null values in the column
+        size_t count = 0;
+        // Same as the corresponding Results functions: sum is 0 and the others
+        // are none when there are no values, and sum and average are always
+        // none for datetime columns
+        util::Optional<Mixed> min;
+        util::Optional<Mixed> max;
+        util::Optional<Mixed> sum;
+        util::Optional<Mixed> average;
+    };
+
+    using Callback = std::function<void (Values const&, std::exception_ptr)>;
+
+    // Throws Results::UnsupportedColumnTypeException for a column which isn't
+    // an int, float, double or datetime column
+    // Throws Results::OutOfBoundsIndexException for an out-of-bounds column
+    // Throws InvalidTransactionException if called in a write transaction or
+    // on a read-only Realm
+    LiveAggregate(Results const& results, size_t column);
+    ~LiveAggregate();
+
+    LiveAggregate(LiveAggregate&&) = default;
+    LiveAggregate(LiveAggregate const&) = delete;
+    LiveAggregate& operator=(LiveAggregate const&) = delete;
+
+    size_t get_column() const noexcept { return m_column; }
+
+    // The values as of the most recently delivered notification, or none if
+    // they haven't been calculated yet
+    util::Optional<Values> get_values() const;
+
+    // Add a callback which is called with the values once they've been
+    // calculated, and then each time they change. Results for a table which
+    // doesn't exist have no values and never call the callback.
+    NotificationToken add_notification_callback(Callback callback);
+
+private:
+    size_t m_column;
+    std::shared_ptr<_impl::AggregateNotifier> m_notifier;
+};
+} // namespace realm
+
+#endif /* REALM_LIVE_AGGREGATE_HPP */
@@ -18,10 +18,13 @@
 
 #include "results.hpp"
 
+#include "impl/limited_query.hpp"
+#include "impl/parallel_query_executor.hpp"
 #include "impl/realm_coordinator.hpp"
 #include "impl/results_notifier.hpp"
 #include "object_store.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 
 using namespace realm;
@@ -115,47 +118,117 @@ size_t Results::size()
     switch (m_mode) {
         case Mode::Empty:    return 0;
         case Mode::Table:    return m_table->size();
-        case Mode::Query:    return m_query.count();
+        case Mode::Query: {
+            size_t count;
+            if (m_parallel_evaluation && can_use_query_executor()) {
+                count = std::min(window_end(), Realm::Internal::get_coordinator(*m_realm).get_query_executor()
+                    .count(Realm::Internal::get_shared_group(*m_realm), m_query));
+            }
+            else {
+                count = m_query.count(0, size_t(-1), window_end());
+            }
+            return count > m_offset ? count - m_offset : 0;
+        }
         case Mode::LinkView: return m_link_view->size();
         case Mode::TableView:
             update_tableview();
-            return m_table_view.size();
+            return limited_size();
     }
     REALM_UNREACHABLE();
 }
 
+bool Results::can_use_query_executor() const
+{
+    // The workers split the query on the rows of its table, so queries over a
+    // LinkView have to be run here. Read-only Realms have no SharedGroup to
+    // hand the query over from, and the workers can't see the uncommitted rows
+    // of a write transaction.
+    return !m_link_view && !m_realm->config().read_only && !m_realm->is_in_transaction();
+}
+
+size_t Results::limited_size() const
+{
+    size_t end = std::min(m_table_view.size(), window_end());
+    return end > m_offset ? end - m_offset : 0;
+}
+
+std::vector<size_t> Results::find_all_row_indices_parallel()
+{
+    validate_read();
+    if (m_mode == Mode::Empty)
+        return {};
+
+    std::vector<size_t> rows;
+
+    // The executor finds the matches in table order, so sorted results and
+    // snapshots are read from the TableView, which has them in the right order
+    if (m_sort || !m_live) {
+        update_tableview();
+        rows.reserve(limited_size());
+        for (size_t i = m_offset, end = m_offset + limited_size(); i < end; ++i)
+            rows.push_back(m_table_view.get_source_ndx(i));
+        return rows;
+    }
+
+    Query query = m_mode == Mode::Query ? m_query : get_query();
+    if (!can_use_query_executor()) {
+        TableView tv = query.find_all(0, size_t(-1), window_end());
+        rows.reserve(tv.size());
+        for (size_t i = 0; i < tv.size(); ++i)
+            rows.push_back(tv.get_source_ndx(i));
+    }
+    else {
+        rows = Realm::Internal::get_coordinator(*m_realm).get_query_executor()
+            .find_all(Realm::Internal::get_shared_group(*m_realm), query);
+    }
+
+    // Unsorted results are in table order, so the window is just a slice of
+    // the matches
+    if (rows.size() > window_end())
+        rows.resize(window_end());
+    rows.erase(rows.begin(), rows.begin() + std::min(m_offset, rows.size()));
+    return rows;
+}
+
 StringData Results::get_object_type() const noexcept
 {
     return get_object_schema().name;
 }
 
 RowExpr Results::get(size_t row_ndx)
+{
+    if (auto row = try_get(row_ndx))
+        return *row;
+    throw OutOfBoundsIndexException{row_ndx, size()};
+}
+
+util::Optional<RowExpr> Results::try_get(size_t row_ndx)
 {
     validate_read();
     switch (m_mode) {
         case Mode::Empty: break;
         case Mode::Table:
             if (row_ndx < m_table->size())
-                return m_table->get(row_ndx);
+                return util::make_optional(m_table->get(row_ndx));
             break;
         case Mode::LinkView:
             if (update_linkview()) {
                if (row_ndx < m_link_view->size())
-                   return m_link_view->get(row_ndx);
+                   return util::make_optional(m_link_view->get(row_ndx));
                 break;
             }
             REALM_FALLTHROUGH;
         case Mode::Query:
         case Mode::TableView:
             update_tableview();
-            if (row_ndx >= m_table_view.size())
+            if (row_ndx >= limited_size())
                 break;
-            if (!m_live && !m_table_view.is_row_attached(row_ndx))
-                return {};
-            return m_table_view.get(row_ndx);
+            if (!m_live && !m_table_view.is_row_attached(m_offset + row_ndx))
+                return util::make_optional(RowExpr());
+            return util::make_optional(m_table_view.get(m_offset + row_ndx));
     }
 
-    throw OutOfBoundsIndexException{row_ndx, size()};
+    return util::none;
 }
 
 util::Optional<RowExpr> Results::first()
@@ -173,7 +246,7 @@ util::Optional<RowExpr> Results::first()
         case Mode::Query:
         case Mode::TableView:
             update_tableview();
-            return m_table_view.size() == 0 ? util::none : util::make_optional(m_table_view.front());
+            return limited_size() == 0 ? util::none : util::make_optional(m_table_view.get(m_offset));
     }
     REALM_UNREACHABLE();
 }
@@ -193,7 +266,7 @@ util::Optional<RowExpr> Results::last()
         case Mode::Query:
         case Mode::TableView:
             update_tableview();
-            return m_table_view.size() == 0 ? util::none : util::make_optional(m_table_view.back());
+            return limited_size() == 0 ? util::none : util::make_optional(m_table_view.get(m_offset + limited_size() - 1));
     }
     REALM_UNREACHABLE();
 }
@@ -218,9 +291,14 @@ void Results::update_tableview()
         case Mode::LinkView:
             return;
         case Mode::Query:
-            m_table_view = m_query.find_all();
-            if (m_sort) {
-                m_table_view.sort(m_sort.column_indices, m_sort.ascending);
+            if (is_limited()) {
+                m_table_view = _impl::find_all_limited(m_query, m_sort, window_end());
+            }
+            else {
+                m_table_view = m_query.find_all();
+                if (m_sort) {
+                    m_table_view.sort(m_sort.column_indices, m_sort.ascending);
+                }
             }
             m_mode = Mode::TableView;
             break;
@@ -233,7 +311,13 @@ void Results::update_tableview()
                 _impl::RealmCoordinator::register_notifier(m_notifier);
             }
             m_has_used_table_view = true;
-            m_table_view.sync_if_needed();
+            if (is_limited() && m_sort) {
+                if (!m_table_view.is_in_sync())
+                    m_table_view = _impl::find_all_limited(m_query, m_sort, window_end());
+            }
+            else {
+                m_table_view.sync_if_needed();
+            }
             break;
     }
 }
@@ -268,11 +352,90 @@ size_t Results::index_of(size_t row_ndx)
         case Mode::Query:
         case Mode::TableView:
             update_tableview();
-            return m_table_view.find_by_source_ndx(row_ndx);
+            size_t ndx = m_table_view.find_by_source_ndx(row_ndx);
+            if (ndx == not_found || ndx < m_offset || ndx >= window_end())
+                return not_found;
+            return ndx - m_offset;
     }
     REALM_UNREACHABLE();
 }
 
+namespace {
+// Computes aggregates over only the rows from `begin` to `end` of a TableView,
+// for a windowed or limited Results whose TableView contains rows outside of
+// the window. Has the same aggregate functions as Table and TableView so the
+// same getters can be used.
+class LimitedRows {
+public:
+    LimitedRows(TableView const& tv, size_t begin, size_t end) : m_tv(tv), m_begin(begin), m_end(end) { }
+
+    int64_t maximum_int(size_t col) const { return reduce<int64_t>(col, [&](size_t i) { return m_tv.get_int(col, i); }, greater()); }
+    float maximum_float(size_t col) const { return reduce<float>(col, [&](size_t i) { return m_tv.get_float(col, i); }, greater()); }
+    double maximum_double(size_t col) const { return reduce<double>(col, [&](size_t i) { return m_tv.get_double(col, i); }, greater()); }
+    DateTime maximum_datetime(size_t col) const { return reduce<DateTime>(col, [&](size_t i) { return m_tv.get_datetime(col, i); }, greater()); }
+
+    int64_t minimum_int(size_t col) const { return reduce<int64_t>(col, [&](size_t i) { return m_tv.get_int(col, i); }, less()); }
+    float minimum_float(size_t col) const { return reduce<float>(col, [&](size_t i) { return m_tv.get_float(col, i); }, less()); }
+    double minimum_double(size_t col) const { return reduce<double>(col, [&](size_t i) { return m_tv.get_double(col, i); }, less()); }
+    DateTime minimum_datetime(size_t col) const { return reduce<DateTime>(col, [&](size_t i) { return m_tv.get_datetime(col, i); }, less()); }
+
+    int64_t sum_int(size_t col) const { return reduce<int64_t>(col, [&](size_t i) { return m_tv.get_int(col, i); }, plus()); }
+    double sum_float(size_t col) const { return reduce<double>(col, [&](size_t i) { return m_tv.get_float(col, i); }, plus()); }
+    double sum_double(size_t col) const { return reduce<double>(col, [&](size_t i) { return m_tv.get_double(col, i); }, plus()); }
+
+    double average_int(size_t col) const { return average(col, [&](size_t i) { return m_tv.get_int(col, i); }); }
+    double average_float(size_t col) const { return average(col, [&](size_t i) { return m_tv.get_float(col, i); }); }
+    double average_double(size_t col) const { return average(col, [&](size_t i) { return m_tv.get_double(col, i); }); }
+
+private:
+    TableView const& m_tv;
+    const size_t m_begin;
+    const size_t m_end;
+
+    struct greater {
+        template<typename T> T operator()(T a, T b) const { return b.get_datetime() > a.get_datetime() ? b : a; }
+        int64_t operator()(int64_t a, int64_t b) const { return std::max(a, b); }
+        float operator()(float a, float b) const { return std::max(a, b); }
+        double operator()(double a, double b) const { return std::max(a, b); }
+    };
+    struct less {
+        template<typename T> T operator()(T a, T b) const { return b.get_datetime() < a.get_datetime() ? b : a; }
+        int64_t operator()(int64_t a, int64_t b) const { return std::min(a, b); }
+        float operator()(float a, float b) const { return std::min(a, b); }
+        double operator()(double a, double b) const { return std::min(a, b); }
+    };
+    struct plus {
+        template<typename T> T operator()(T a, T b) const { return a + b; }
+    };
+
+    // Combines the values of the non-null rows, returning the value for the
+    // first one (or a default-constructed value) for min/max when there's just one
+    template<typename T, typename Getter, typename Combine>
+    T reduce(size_t col, Getter get, Combine combine, size_t* count = nullptr) const
+    {
+        T result{};
+        size_t n = 0;
+        for (size_t i = m_begin; i < m_end; ++i) {
+            if (!m_tv.is_row_attached(i) || m_tv.is_null(col, i))
+                continue;
+            T value = get(i);
+            result = n++ == 0 ? value : combine(result, value);
+        }
+        if (count)
+            *count = n;
+        return result;
+    }
+
+    template<typename Getter>
+    double average(size_t col, Getter get) const
+    {
+        size_t count;
+        double sum = reduce<double>(col, get, plus(), &count);
+        return count ? sum / count : 0;
+    }
+};
+} // anonymous namespace
+
 template<typename Int, typename Float, typename Double, typename DateTime>
 util::Optional<Mixed> Results::aggregate(size_t column, bool return_none_for_empty,
                                          Int agg_int, Float agg_float,
@@ -299,8 +462,10 @@ util::Optional<Mixed> Results::aggregate(size_t column, bool return_none_for_emp
             case Mode::Query:
             case Mode::TableView:
                 this->update_tableview();
-                if (return_none_for_empty && m_table_view.size() == 0)
+                if (return_none_for_empty && limited_size() == 0)
                     return none;
+                if (m_offset > 0 || m_table_view.size() > window_end())
+                    return util::Optional<Mixed>(getter(LimitedRows(m_table_view, m_offset, m_offset + limited_size())));
                 return util::Optional<Mixed>(getter(m_table_view));
         }
         REALM_UNREACHABLE();
@@ -353,6 +518,247 @@ util::Optional<Mixed> Results::average(size_t column)
                      [=](auto const&) -> util::None { throw UnsupportedColumnTypeException{column, m_table}; });
 }
 
+namespace {
+// Accumulates the statistics for one column for aggregate_many(). Values are
+// gathered into a buffer a block of rows at a time and then reduced with loops
+// which have no branches, so that the compiler can vectorize them.
+class ColumnAggregator {
+public:
+    static const size_t block_size = 1024;
+
+    ColumnAggregator(size_t column, DataType type) : m_column(column), m_type(type) { }
+
+    size_t column() const { return m_column; }
+
+    // Add the values for rows [begin, end) of source, which is either a Table
+    // or a TableView
+    template<typename Source, typename IsAttached>
+    void add_rows(Source const& source, size_t begin, size_t end, IsAttached const& is_attached)
+    {
+        switch (m_type) {
+            case type_Int:
+                m_ints.add(begin, end, is_attached, [&](size_t i) { return source.is_null(m_column, i); },
+                           [&](size_t i) { return source.get_int(m_column, i); });
+                break;
+            case type_Float:
+                m_floats.add(begin, end, is_attached, [&](size_t i) { return source.is_null(m_column, i); },
+                             [&](size_t i) { return source.get_float(m_column, i); });
+                break;
+            case type_Double:
+                m_doubles.add(begin, end, is_attached, [&](size_t i) { return source.is_null(m_column, i); },
+                              [&](size_t i) { return source.get_double(m_column, i); });
+                break;
+            case type_DateTime:
+                m_ints.add(begin, end, is_attached, [&](size_t i) { return source.is_null(m_column, i); },
+                           [&](size_t i) { return int64_t(source.get_datetime(m_column, i).get_datetime()); });
+                break;
+            default:
+                REALM_UNREACHABLE();
+        }
+    }
+
+    // Add every row of table with core's column aggregates, which work on the
+    // column's leaves rather than reading a row at a time. Returns false if
+    // the number of non-null values can't be found that way.
+    bool add_table(Table const& table)
+    {
+        size_t count = table.size();
+        const bool nullable = table.is_nullable(m_column);
+        switch (m_type) {
+            case type_Int:
+                if (nullable)
+                    table.average_int(m_column, &count);
+                if (count)
+                    m_ints.set(count, table.minimum_int(m_column), table.maximum_int(m_column), table.sum_int(m_column));
+                return true;
+            case type_Float:
+                if (nullable)
+                    table.average_float(m_column, &count);
+                if (count)
+                    m_floats.set(count, table.minimum_float(m_column), table.maximum_float(m_column), table.sum_float(m_column));
+                return true;
+            case type_Double:
+                if (nullable)
+                    table.average_double(m_column, &count);
+                if (count)
+                    m_doubles.set(count, table.minimum_double(m_column), table.maximum_double(m_column), table.sum_double(m_column));
+                return true;
+            case type_DateTime:
+                if (nullable)
+                    return false;
+                if (count)
+                    m_ints.set(count, table.minimum_datetime(m_column).get_datetime(),
+                               table.maximum_datetime(m_column).get_datetime(), 0);
+                return true;
+            default:
+                REALM_UNREACHABLE();
+        }
+    }
+
+    util::Optional<Mixed> get(Results::AggregateOp op) const
+    {
+        switch (m_type) {
+            case type_Int:
+                return m_ints.get(op, [](int64_t value) { return Mixed(value); });
+            case type_Float:
+                return m_floats.get(op, [](float value) { return Mixed(value); });
+            case type_Double:
+                return m_doubles.get(op, [](double value) { return Mixed(value); });
+            case type_DateTime:
+                return m_ints.get(op, [](int64_t value) { return Mixed(DateTime(time_t(value))); });
+            default:
+                REALM_UNREACHABLE();
+        }
+    }
+
+private:
+    template<typename T, typename Sum>
+    struct Stats {
+        size_t count = 0;
+        T min{}, max{};
+        Sum sum = 0;
+
+        template<typename IsAttached, typename IsNull, typename Getter>
+        void add(size_t begin, size_t end, IsAttached const& is_attached, IsNull const& is_null, Getter const& get)
+        {
+            T buffer[block_size];
+            size_t n = 0;
+            for (size_t i = begin; i < end; ++i) {
+                if (!is_attached(i) || is_null(i))
+                    continue;
+                buffer[n++] = get(i);
+                if (n == block_size) {
+                    reduce(buffer, n);
+                    n = 0;
+                }
+            }
+            reduce(buffer, n);
+        }
+
+        void set(size_t n, T min_value, T max_value, Sum sum_value)
+        {
+            count = n;
+            min = min_value;
+            max = max_value;
+            sum = sum_value;
+        }
+
+        void reduce(T const* values, size_t n)
+        {
+            if (n == 0)
+                return;
+            T block_min = values[0], block_max = values[0];
+            Sum block_sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                block_min = values[i] < block_min ? values[i] : block_min;
+                block_max = block_max < values[i] ? values[i] : block_max;
+                block_sum += values[i];
+            }
+            min = count == 0 || block_min < min ? block_min : min;
+            max = count == 0 || max < block_max ? block_max : max;
+            sum += block_sum;
+            count += n;
+        }
+
+        template<typename ToMixed>
+        util::Optional<Mixed> get(Results::AggregateOp op, ToMixed const& to_mixed) const
+        {
+            switch (op) {
+                case Results::AggregateOp::Count:
+                    return Mixed(int64_t(count));
+                case Results::AggregateOp::Min:
+                    return count ? util::make_optional(to_mixed(min)) : util::none;
+                case Results::AggregateOp::Max:
+                    return count ? util::make_optional(to_mixed(max)) : util::none;
+                case Results::AggregateOp::Sum:
+                    return Mixed(sum);
+                case Results::AggregateOp::Average:
+                    return count ? util::make_optional(Mixed(double(sum) / count)) : util::none;
+            }
+            REALM_UNREACHABLE();
+        }
+    };
+
+    size_t m_column;
+    DataType m_type;
+    Stats<int64_t, int64_t> m_ints;
+    Stats<float, double> m_floats;
+    Stats<double, double> m_doubles;
+};
+} // anonymous namespace
+
+std::vector<util::Optional<Mixed>> Results::aggregate_many(std::vector<Aggregate> const& aggregates)
+{
+    validate_read();
+    if (!m_table)
+        return std::vector<util::Optional<Mixed>>(aggregates.size());
+
+    // Validate all of the requests before doing any work, and set up one
+    // aggregator for each distinct column
+    std::vector<ColumnAggregator> columns;
+    for (auto const& aggregate : aggregates) {
+        if (aggregate.column >= m_table->get_column_count())
+            throw OutOfBoundsIndexException{aggregate.column, m_table->get_column_count()};
+        auto type = m_table->get_column_type(aggregate.column);
+        switch (type) {
+            case type_DateTime:
+                if (aggregate.op == AggregateOp::Sum || aggregate.op == AggregateOp::Average)
+                    throw UnsupportedColumnTypeException{aggregate.column, m_table};
+                break;
+            case type_Int:
+            case type_Float:
+            case type_Double:
+                break;
+            default:
+                throw UnsupportedColumnTypeException{aggregate.column, m_table};
+        }
+        auto it = std::find_if(columns.begin(), columns.end(),
+                               [&](auto const& c) { return c.column() == aggregate.column; });
+        if (it == columns.end())
+            columns.emplace_back(aggregate.column, type);
+    }
+
+    auto add_rows = [&](auto const& source, size_t begin, size_t end, auto const& is_attached) {
+        // Process the rows in blocks for all of the columns at once so that
+        // each row is only visited while it's still in the cache
+        for (size_t block_begin = begin; block_begin < end; block_begin += ColumnAggregator::block_size) {
+            size_t block_end = std::min(end, block_begin + ColumnAggregator::block_size);
+            for (auto& column : columns)
+                column.add_rows(source, block_begin, block_end, is_attached);
+        }
+    };
+
+    switch (m_mode) {
+        case Mode::Empty:
+            break;
+        case Mode::Table:
+            for (auto& column : columns) {
+                if (!column.add_table(*m_table))
+                    column.add_rows(*m_table, 0, m_table->size(), [](size_t) { return true; });
+            }
+            break;
+        case Mode::LinkView:
+            m_query = get_query();
+            m_mode = Mode::Query;
+            REALM_FALLTHROUGH;
+        case Mode::Query:
+        case Mode::TableView:
+            update_tableview();
+            add_rows(m_table_view, m_offset, m_offset + limited_size(),
+                     [&](size_t i) { return m_table_view.is_row_attached(i); });
+            break;
+    }
+
+    std::vector<util::Optional<Mixed>> results;
+    results.reserve(aggregates.size());
+    for (auto const& aggregate : aggregates) {
+        auto it = std::find_if(columns.begin(), columns.end(),
+                               [&](auto const& c) { return c.column() == aggregate.column; });
+        results.push_back(it->get(aggregate.op));
+    }
+    return results;
+}
+
 void Results::clear()
 {
     switch (m_mode) {
@@ -368,7 +774,22 @@ void Results::clear()
         case Mode::TableView:
             validate_write();
             update_tableview();
-            m_table_view.clear(RemoveMode::unordered);
+            if (m_offset > 0 || m_table_view.size() > window_end()) {
+                // Deleting in descending order ensures that move_last_over()
+                // never moves one of the rows still to be deleted
+                std::vector<size_t> rows;
+                rows.reserve(limited_size());
+                for (size_t i = m_offset, end = m_offset + limited_size(); i < end; ++i) {
+                    if (m_table_view.is_row_attached(i))
+                        rows.push_back(m_table_view.get_source_ndx(i));
+                }
+                std::sort(rows.begin(), rows.end(), std::greater<size_t>());
+                for (size_t row : rows)
+                    m_table->move_last_over(row);
+            }
+            else {
+                m_table_view.clear(RemoveMode::unordered);
+            }
             break;
         case Mode::LinkView:
             validate_write();
@@ -385,6 +806,10 @@ Query Results::get_query() const
         case Mode::Query:
             return m_query;
         case Mode::TableView:
+            // The TableView for a limited Results may have been created from
+            // a more restrictive query
+            if (is_limited() || m_offset > 0)
+                return m_query;
             return m_table_view.get_query();
         case Mode::LinkView:
             return m_table->where(m_link_view);
@@ -417,16 +842,36 @@ TableView Results::get_tableview()
 Results Results::sort(realm::SortOrder&& sort) const
 {
     REALM_ASSERT(sort.column_indices.size() == sort.ascending.size());
-    if (m_link_view)
-        return Results(m_realm, *m_object_schema, m_link_view, m_query, std::move(sort));
-    return Results(m_realm, *m_object_schema, get_query(), std::move(sort));
+    Results ret = m_link_view ? Results(m_realm, *m_object_schema, m_link_view, m_query, std::move(sort))
+                              : Results(m_realm, *m_object_schema, get_query(), std::move(sort));
+    ret.m_offset = m_offset;
+    ret.m_limit = m_limit;
+    return ret;
 }
 
 Results Results::filter(Query&& q) const
 {
-    if (m_link_view)
-        return Results(m_realm, *m_object_schema, m_link_view, get_query().and_query(std::move(q)), m_sort);
-    return Results(m_realm, *m_object_schema, get_query().and_query(std::move(q)), m_sort);
+    Results ret = m_link_view ? Results(m_realm, *m_object_schema, m_link_view, get_query().and_query(std::move(q)), m_sort)
+                              : Results(m_realm, *m_object_schema, get_query().and_query(std::move(q)), m_sort);
+    ret.m_offset = m_offset;
+    ret.m_limit = m_limit;
+    return ret;
+}
+
+Results Results::limit(size_t max_count) const
+{
+    return window(0, max_count);
+}
+
+Results Results::window(size_t offset, size_t length) const
+{
+    Results ret = m_link_view ? Results(m_realm, *m_object_schema, m_link_view, get_query(), m_sort)
+                              : Results(m_realm, *m_object_schema, get_query(), m_sort);
+    ret.m_offset = m_offset + offset;
+    if (is_limited())
+        length = std::min(length, offset < m_limit ? m_limit - offset : 0);
+    ret.m_limit = length;
+    return ret;
 }
 
 void Results::prepare_async()
@@ -451,10 +896,10 @@ NotificationToken Results::async(std::function<void (std::exception_ptr)> target
     return {m_notifier, m_notifier->add_callback(wrap)};
 }
 
-NotificationToken Results::add_notification_callback(CollectionChangeCallback cb)
+NotificationToken Results::add_notification_callback(CollectionChangeCallback cb, NotificationPriority priority)
 {
     prepare_async();
-    return {m_notifier, m_notifier->add_callback(std::move(cb))};
+    return {m_notifier, m_notifier->add_callback(std::move(cb), priority)};
 }
 
 void Results::Internal::set_table_view(Results& results, realm::TableView &&tv)
@@ -472,6 +917,15 @@ void Results::Internal::set_table_view(Results& results, realm::TableView &&tv)
     REALM_ASSERT(results.m_table_view.is_attached());
 }
 
+void Results::Internal::keep_table_view(Results& results)
+{
+    // The notifier only skips creating a TableView while the previous one is
+    // unused, so start sending them again once the user has used it
+    if (results.m_has_used_table_view) {
+        results.m_wants_background_updates = true;
+    }
+}
+
 Results::UnsupportedColumnTypeException::UnsupportedColumnTypeException(size_t column, const Table* table)
 : std::runtime_error((std::string)"Operation not supported on '" + table->get_column_name(column).data() + "' columns")
 , column_index(column)
@@ -73,18 +73,44 @@ public:
     // Get the currently applied sort order for this Results
     SortOrder const& get_sort() const noexcept { return m_sort; }
 
+    // Get the maximum number of rows in this Results, or -1 if it isn't limited
+    size_t get_limit() const noexcept { return m_limit; }
+
+    // Get the number of rows of the underlying query which are skipped before
+    // the first row of this Results
+    size_t get_offset() const noexcept { return m_offset; }
+
     // Get a tableview containing the same rows as this Results
+    // For a windowed or limited Results the tableview can contain extra rows
+    // before the first get_offset() rows and after the first get_limit() rows
     TableView get_tableview();
 
     // Get the object type which will be returned by get()
     StringData get_object_type() const noexcept;
 
+    // Get the table the rows in this Results belong to, or null if the mode is Empty
+    Table* get_table() const noexcept { return m_table; }
+
     // Get the LinkView this Results is derived from, if any
     LinkViewRef get_linkview() const { return m_link_view; }
 
     // Set whether the TableView should sync if needed before accessing results
     void set_live(bool live);
 
+    // Set whether size() should count the matching rows on the coordinator's
+    // worker threads rather than on the calling thread. Only affects Results
+    // backed by a Query over a whole table which has not been run yet, outside
+    // of write transactions. Must not be set for queries restricted to a
+    // TableView, as the workers split the query on the rows of the table.
+    void set_parallel_evaluation(bool parallel) { m_parallel_evaluation = parallel; }
+
+    // Get the indices in the table of the rows in this Results, in the same
+    // order as get(). Unsorted queries are evaluated on the coordinator's
+    // worker threads; sorted Results and snapshots read their TableView, and
+    // Results derived from a LinkView or read in a write transaction are
+    // evaluated on the calling thread.
+    std::vector<size_t> find_all_row_indices_parallel();
+
     // Get the size of this results
     // Can be either O(1) or O(N) depending on the state of things
     size_t size();
@@ -93,6 +119,11 @@ public:
     // Throws OutOfBoundsIndexException if index >= size()
     RowExpr get(size_t index);
 
+    // Get the row accessor for the given index, or none if index >= size()
+    // Checks the bounds after running the query rather than before, so unlike
+    // size()+get() it never evaluates the query twice
+    util::Optional<RowExpr> try_get(size_t index);
+
     // Get a row accessor for the first/last row, or none if the results are empty
     // More efficient than calling size()+get()
     util::Optional<RowExpr> first();
@@ -110,9 +141,19 @@ public:
     void clear();
 
     // Create a new Results by further filtering or sorting this Results
+    // The limit of a limited Results is applied after the new filter or sort
     Results filter(Query&& q) const;
     Results sort(SortOrder&& sort) const;
 
+    // Create a new Results containing only the first max_count rows of this Results
+    // Only the rows which can be in the first max_count are sorted
+    Results limit(size_t max_count) const;
+
+    // Create a new Results containing only the rows from offset to
+    // offset + length of this Results, where indices and notifications are
+    // relative to the start of the window
+    Results window(size_t offset, size_t length) const;
+
     // Get the min/max/average/sum of the given column
     // All but sum() returns none when there are zero matching rows
     // sum() returns 0, except for when it returns none
@@ -123,6 +164,25 @@ public:
     util::Optional<Mixed> average(size_t column);
     util::Optional<Mixed> sum(size_t column);
 
+    enum class AggregateOp : uint8_t {
+        Count, // Number of non-null values in the column
+        Min,
+        Max,
+        Sum,
+        Average
+    };
+    struct Aggregate {
+        size_t column;
+        AggregateOp op;
+    };
+
+    // Compute several aggregates with a single pass over the rows, returning
+    // the results in the same order as the requested aggregates. Results for
+    // a whole table use core's column aggregates instead.
+    // Min/max/average/sum behave the same as the individual functions, and
+    // throw the same exceptions
+    std::vector<util::Optional<Mixed>> aggregate_many(std::vector<Aggregate> const& aggregates);
+
     enum class Mode {
         Empty, // Backed by nothing (for missing tables)
         Table, // Backed directly by a Table
@@ -178,7 +238,8 @@ public:
     // The query will be run on a background thread and delivered to the callback,
     // and then rerun after each commit (if needed) and redelivered if it changed
     NotificationToken async(std::function<void (std::exception_ptr)> target);
-    NotificationToken add_notification_callback(CollectionChangeCallback cb);
+    NotificationToken add_notification_callback(CollectionChangeCallback cb,
+                                                NotificationPriority priority = NotificationPriority::Normal);
 
     bool wants_background_updates() const { return m_wants_background_updates; }
 
@@ -187,6 +248,9 @@ public:
     class Internal {
         friend class _impl::ResultsNotifier;
         static void set_table_view(Results& results, TableView&& tv);
+        // Called instead of set_table_view() when a notification is delivered
+        // without a new TableView
+        static void keep_table_view(Results& results);
     };
 
 private:
@@ -197,7 +261,10 @@ private:
     LinkViewRef m_link_view;
     Table* m_table = nullptr;
     SortOrder m_sort;
+    size_t m_offset = 0;
+    size_t m_limit = -1;
     bool m_live = true;
+    bool m_parallel_evaluation = false;
 
     std::shared_ptr<_impl::ResultsNotifier> m_notifier;
 
@@ -207,6 +274,16 @@ private:
 
     void update_tableview();
     bool update_linkview();
+    bool is_limited() const noexcept { return m_limit != size_t(-1); }
+    // Index in the TableView just after the last row in this Results, or -1
+    size_t window_end() const noexcept
+    {
+        return is_limited() && m_limit < size_t(-1) - m_offset ? m_offset + m_limit : size_t(-1);
+    }
+    // Size of the TableView with the offset and limit applied
+    size_t limited_size() const;
+    // Whether the query can be handed over to the coordinator's query executor
+    bool can_use_query_executor() const;
 
     void validate_read() const;
     void validate_write() const;
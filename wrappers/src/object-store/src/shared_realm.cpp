@@ -37,6 +37,8 @@ Realm::Config::Config(const Config& c)
 , migration_function(c.migration_function)
 , read_only(c.read_only)
 , in_memory(c.in_memory)
+, notifier_threads(c.notifier_threads)
+, notification_rate_limit(c.notification_rate_limit)
 , cache(c.cache)
 , disable_format_upgrade(c.disable_format_upgrade)
 , automatic_change_notifications(c.automatic_change_notifications)
@@ -23,6 +23,7 @@
 
 #include <realm/handover_defs.hpp>
 
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -66,6 +67,33 @@ namespace realm {
             bool read_only = false;
             bool in_memory = false;
 
+            // Number of threads used to run the change notifiers for the Realm
+            // file after each commit, or 0 for one per core. Only the first
+            // Config used to open a file determines this.
+            size_t notifier_threads = 1;
+
+            // Limits on how often change notifications are calculated after
+            // commits, for when there are more commits than readers need to
+            // see. Commits made while a run of the notifiers is held back are
+            // folded into that run, so they produce a single notification.
+            // By default every commit is processed as soon as it is seen. Like
+            // notifier_threads, only the first Config for a file is used.
+            struct NotificationRateLimit {
+                // Minimum time between the starts of two runs of the notifiers
+                std::chrono::milliseconds min_interval{0};
+                // Maximum time a commit waits for the notifiers to be run once
+                // it has been seen, measured from the first commit which is
+                // still waiting. This wins over min_interval, so if it is
+                // shorter, a continuous stream of commits is run every
+                // max_latency. Zero for no maximum.
+                std::chrono::milliseconds max_latency{0};
+                // If false, Realms are still told about each commit as soon as
+                // it's seen, so a Realm without notifiers can refresh to every
+                // version. If true, they're only told after the held-back run,
+                // so they skip the intermediate versions too.
+                bool skip_intermediate_versions = false;
+            } notification_rate_limit;
+
             // The following are intended for internal/testing purposes and
             // should not be publically exposed in binding APIs
 
@@ -150,6 +178,7 @@ namespace realm {
             friend class _impl::ListNotifier;
             friend class _impl::RealmCoordinator;
             friend class _impl::ResultsNotifier;
+            friend class Results;
 
             // ResultsNotifier and ListNotifier need access to the SharedGroup
             // to be able to call the handover functions, which are not very wrappable
@@ -157,7 +186,8 @@ namespace realm {
 
             // CollectionNotifier needs to be able to access the owning
             // coordinator to wake up the worker thread when a callback is
-            // added, and coordinators need to be able to get themselves from a Realm
+            // added, coordinators need to be able to get themselves from a Realm,
+            // and Results uses the coordinator's workers for parallel queries
             static _impl::RealmCoordinator& get_coordinator(Realm& realm) { return *realm.m_coordinator; }
         };
 
@@ -43,8 +43,8 @@ namespace util {
 // A wrapper for std::shared_ptr that enables sharing a shared_ptr instance
 // (and not just a thing *pointed to* by a shared_ptr) between threads. Is
 // lock-free iff the underlying shared_ptr implementation supports atomic
-// operations. Currently the only implemented operation other than copy/move
-// construction/assignment is exchange().
+// operations. Currently the only implemented operations other than copy/move
+// construction/assignment are load() and exchange().
 template<typename T, bool = _impl::HasAtomicPtrOps<std::shared_ptr<T>>::value>
 class AtomicSharedPtr;
 
@@ -71,6 +71,11 @@ public:
         return *this;
     }
 
+    std::shared_ptr<T> load() const
+    {
+        return std::atomic_load(&m_ptr);
+    }
+
     std::shared_ptr<T> exchange(std::shared_ptr<T> ptr)
     {
         return std::atomic_exchange(&m_ptr, std::move(ptr));
@@ -119,6 +124,12 @@ public:
         return *this;
     }
 
+    std::shared_ptr<T> load() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_ptr;
+    }
+
     std::shared_ptr<T> exchange(std::shared_ptr<T> ptr)
     {
         std::lock_guard<std::mutex> lock(m_mutex);
@@ -127,7 +138,7 @@ public:
     }
 
 private:
-    std::mutex m_mutex;
+    mutable std::mutex m_mutex;
     std::shared_ptr<T> m_ptr = nullptr;
 };
 
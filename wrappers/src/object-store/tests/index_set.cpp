@@ -579,3 +579,34 @@ TEST_CASE("[index_set] clear()") {
         REQUIRE(set.empty());
     }
 }
+
+TEST_CASE("[index_set] chunks()") {
+    realm::IndexSet set;
+
+    SECTION("is empty for an empty set") {
+        REQUIRE(set.chunks().empty());
+    }
+
+    SECTION("holds every range in the set, in order, with per-chunk counts") {
+        for (size_t i = 0; i < 1000; i += 2)
+            set.add(i);
+        set.add(5000);
+
+        std::vector<std::pair<size_t, size_t>> ranges;
+        size_t count = 0;
+        for (auto& chunk : set.chunks()) {
+            ranges.insert(ranges.end(), chunk.data.begin(), chunk.data.end());
+            count += chunk.count;
+        }
+        REQUIRE(ranges == std::vector<std::pair<size_t, size_t>>(set.begin(), set.end()));
+        REQUIRE(count == set.count());
+        REQUIRE(set.chunks().size() > 1);
+    }
+
+    SECTION("stores a single range for a contiguous set of any size") {
+        set.set(1000000);
+        REQUIRE(set.chunks().size() == 1);
+        REQUIRE(set.chunks()[0].data.size() == 1);
+        REQUIRE(set.chunks()[0].count == 1000000);
+    }
+}
@@ -0,0 +1,271 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+
+#include "util/test_file.hpp"
+
+#include "live_aggregate.hpp"
+#include "object_schema.hpp"
+#include "property.hpp"
+#include "results.hpp"
+#include "schema.hpp"
+
+#include <realm/group_shared.hpp>
+
+using namespace realm;
+
+TEST_CASE("LiveAggregate") {
+    InMemoryTestFile config;
+    config.cache = false;
+    config.automatic_change_notifications = false;
+    config.schema = std::make_unique<Schema>(Schema{
+        {"object", "", {
+            {"value", PropertyTypeInt, "", false, false, true},
+            {"double", PropertyTypeDouble},
+            {"date", PropertyTypeDate},
+            {"string", PropertyTypeString}
+        }}
+    });
+
+    auto r = Realm::get_shared_realm(config);
+    auto table = r->read_group()->get_table("class_object");
+    auto& object_schema = *config.schema->find("object");
+
+    r->begin_transaction();
+    table->add_empty_row(10);
+    for (int i = 0; i < 10; ++i) {
+        table->set_int(0, i, i * 2);
+        table->set_double(1, i, i / 2.0);
+        table->set_datetime(2, i, DateTime(100 + i));
+    }
+    r->commit_transaction();
+
+    Results results(r, object_schema, table->where().greater(0, 0).less(0, 15));
+
+    auto write = [&](auto&& f) {
+        r->begin_transaction();
+        f();
+        r->commit_transaction();
+        advance_and_notify(*r);
+    };
+
+    LiveAggregate aggregate(results, 0);
+    int notification_calls = 0;
+    LiveAggregate::Values values;
+    auto token = aggregate.add_notification_callback([&](LiveAggregate::Values const& v, std::exception_ptr err) {
+        REQUIRE_FALSE(err);
+        values = v;
+        ++notification_calls;
+    });
+
+    auto require_matches_results = [&] {
+        REQUIRE(values.count == results.size());
+        REQUIRE(values.sum->get_int() == results.sum(0)->get_int());
+        if (values.count) {
+            REQUIRE(values.min->get_int() == results.min(0)->get_int());
+            REQUIRE(values.max->get_int() == results.max(0)->get_int());
+            REQUIRE(values.average->get_double() == results.average(0)->get_double());
+        }
+        else {
+            REQUIRE_FALSE(values.min);
+            REQUIRE_FALSE(values.max);
+            REQUIRE_FALSE(values.average);
+        }
+    };
+
+    SECTION("values are not calculated synchronously") {
+        REQUIRE_FALSE(aggregate.get_values());
+        REQUIRE(notification_calls == 0);
+    }
+
+    SECTION("initial values are delivered") {
+        advance_and_notify(*r);
+        REQUIRE(notification_calls == 1);
+        REQUIRE(values.count == 7);
+        REQUIRE(values.min->get_int() == 2);
+        REQUIRE(values.max->get_int() == 14);
+        REQUIRE(values.sum->get_int() == 56);
+        REQUIRE(values.average->get_double() == 8.0);
+        REQUIRE(aggregate.get_values()->count == 7);
+    }
+
+    SECTION("appending rows updates the values") {
+        advance_and_notify(*r);
+        write([&] {
+            table->set_int(0, table->add_empty_row(), 1);
+            table->set_int(0, table->add_empty_row(), 20);
+        });
+        REQUIRE(notification_calls == 2);
+        REQUIRE(values.min->get_int() == 1);
+        require_matches_results();
+    }
+
+    SECTION("deleting the row with the minimum value updates the minimum") {
+        advance_and_notify(*r);
+        write([&] { table->move_last_over(1); });
+        REQUIRE(notification_calls == 2);
+        REQUIRE(values.min->get_int() == 4);
+        require_matches_results();
+    }
+
+    SECTION("deleting a row which doesn't match doesn't change the values") {
+        advance_and_notify(*r);
+        write([&] { table->move_last_over(9); });
+        REQUIRE(notification_calls == 1);
+        write([&] { table->move_last_over(0); });
+        REQUIRE(notification_calls == 1);
+        require_matches_results();
+    }
+
+    SECTION("modifying a row so that it no longer matches removes its value") {
+        advance_and_notify(*r);
+        write([&] { table->set_int(0, 7, 100); });
+        REQUIRE(notification_calls == 2);
+        REQUIRE(values.max->get_int() == 12);
+        require_matches_results();
+    }
+
+    SECTION("setting a matching row to null removes its value") {
+        advance_and_notify(*r);
+        write([&] { table->set_null(0, 3); });
+        REQUIRE(notification_calls == 2);
+        REQUIRE(values.count == 6);
+        REQUIRE(values.sum->get_int() == 50);
+    }
+
+    SECTION("modifying another column doesn't call the callback") {
+        advance_and_notify(*r);
+        write([&] { table->set_double(1, 3, 10.0); });
+        REQUIRE(notification_calls == 1);
+    }
+
+    SECTION("mixed inserts, deletions and modifications") {
+        advance_and_notify(*r);
+        write([&] {
+            table->set_int(0, table->add_empty_row(), 3);
+            table->move_last_over(2);
+            table->set_int(0, 5, 13);
+            table->move_last_over(0);
+            table->set_int(0, table->add_empty_row(), 9);
+        });
+        REQUIRE(notification_calls == 2);
+        require_matches_results();
+    }
+
+    SECTION("small changes to a large table") {
+        write([&] {
+            size_t first = table->add_empty_row(1000);
+            for (size_t i = first; i < table->size(); ++i)
+                table->set_int(0, i, i % 15);
+        });
+        require_matches_results();
+
+        write([&] {
+            table->move_last_over(1);
+            table->move_last_over(500);
+            table->set_int(0, table->add_empty_row(), -5);
+            table->set_int(0, 20, 2);
+        });
+        require_matches_results();
+
+        write([&] {
+            for (size_t i = 0; i < table->size(); ++i) {
+                if (table->get_int(0, i) == 14)
+                    table->set_int(0, i, 3);
+            }
+        });
+        REQUIRE(values.max->get_int() == 13);
+        require_matches_results();
+    }
+
+    SECTION("clearing the table") {
+        advance_and_notify(*r);
+        write([&] { table->clear(); });
+        REQUIRE(notification_calls == 2);
+        REQUIRE(values.count == 0);
+        REQUIRE(values.sum->get_int() == 0);
+        REQUIRE_FALSE(values.min);
+
+        write([&] { table->set_int(0, table->add_empty_row(), 5); });
+        REQUIRE(values.count == 1);
+        REQUIRE(values.min->get_int() == 5);
+        REQUIRE(values.max->get_int() == 5);
+    }
+
+    SECTION("values are not updated after the aggregate is destroyed") {
+        advance_and_notify(*r);
+        {
+            LiveAggregate other(results, 0);
+            token = other.add_notification_callback([&](LiveAggregate::Values const&, std::exception_ptr) {
+                ++notification_calls;
+            });
+        }
+        write([&] { table->set_int(0, 3, 5); });
+        REQUIRE(notification_calls == 1);
+    }
+
+    SECTION("windowed results only aggregate the rows in the window") {
+        LiveAggregate windowed(results.sort({{0}, {false}}).window(1, 3), 0);
+        LiveAggregate::Values windowed_values;
+        auto windowed_token = windowed.add_notification_callback([&](LiveAggregate::Values const& v, std::exception_ptr) {
+            windowed_values = v;
+        });
+        advance_and_notify(*r);
+        REQUIRE(windowed_values.count == 3);
+        REQUIRE(windowed_values.max->get_int() == 12);
+        REQUIRE(windowed_values.min->get_int() == 8);
+
+        write([&] { table->set_int(0, table->add_empty_row(), 11); });
+        REQUIRE(windowed_values.max->get_int() == 12);
+        REQUIRE(windowed_values.min->get_int() == 10);
+    }
+
+    SECTION("double and datetime columns") {
+        LiveAggregate doubles(results, 1), dates(results, 2);
+        LiveAggregate::Values double_values, date_values;
+        auto double_token = doubles.add_notification_callback([&](LiveAggregate::Values const& v, std::exception_ptr) {
+            double_values = v;
+        });
+        auto date_token = dates.add_notification_callback([&](LiveAggregate::Values const& v, std::exception_ptr) {
+            date_values = v;
+        });
+        advance_and_notify(*r);
+        REQUIRE(double_values.sum->get_double() == results.sum(1)->get_double());
+        REQUIRE(double_values.max->get_double() == 3.5);
+        REQUIRE(date_values.min->get_datetime().get_datetime() == 101);
+        REQUIRE(date_values.max->get_datetime().get_datetime() == 107);
+        REQUIRE_FALSE(date_values.sum);
+        REQUIRE_FALSE(date_values.average);
+
+        write([&] { table->move_last_over(7); });
+        REQUIRE(double_values.max->get_double() == 3.0);
+        REQUIRE(date_values.max->get_datetime().get_datetime() == 106);
+    }
+
+    SECTION("unsupported columns") {
+        REQUIRE_THROWS_AS(LiveAggregate(results, 3), Results::UnsupportedColumnTypeException);
+        REQUIRE_THROWS_AS(LiveAggregate(results, 4), Results::OutOfBoundsIndexException);
+    }
+
+    SECTION("cannot be created in a write transaction") {
+        r->begin_transaction();
+        REQUIRE_THROWS(LiveAggregate(results, 0));
+        r->cancel_transaction();
+    }
+}
@@ -21,6 +21,7 @@
 #include "util/index_helpers.hpp"
 #include "util/test_file.hpp"
 
+#include "impl/parallel_query_executor.hpp"
 #include "impl/realm_coordinator.hpp"
 #include "object_schema.hpp"
 #include "property.hpp"
@@ -31,6 +32,10 @@
 #include <realm/group_shared.hpp>
 #include <realm/link_view.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
 #include <unistd.h>
 
 using namespace realm;
@@ -426,6 +431,541 @@ TEST_CASE("Results") {
     }
 }
 
+TEST_CASE("Results incremental notifications") {
+    InMemoryTestFile config;
+    config.cache = false;
+    config.automatic_change_notifications = false;
+    config.schema = std::make_unique<Schema>(Schema{
+        {"object", "", {
+            {"value", PropertyTypeInt},
+            {"other", PropertyTypeInt}
+        }}
+    });
+
+    auto r = Realm::get_shared_realm(config);
+    auto table = r->read_group()->get_table("class_object");
+
+    r->begin_transaction();
+    table->add_empty_row(1000);
+    for (int i = 0; i < 1000; ++i) {
+        table->set_int(0, i, i % 10);
+        table->set_int(1, i, i);
+    }
+    r->commit_transaction();
+
+    // Matches every tenth row. The TableView is never read, so after the
+    // initial run the notifier can update the results without rerunning the query
+    Results results(r, *config.schema->find("object"), table->where().equal(0, 0));
+
+    int notification_calls = 0;
+    CollectionChangeSet change;
+    auto token = results.add_notification_callback([&](CollectionChangeSet c, std::exception_ptr err) {
+        REQUIRE_FALSE(err);
+        change = c;
+        ++notification_calls;
+    });
+
+    advance_and_notify(*r);
+
+    auto write = [&](auto&& f) {
+        r->begin_transaction();
+        f();
+        r->commit_transaction();
+        advance_and_notify(*r);
+    };
+
+    SECTION("modifying a matching row and leaving it matching marks that row as modified") {
+        write([&] {
+            table->set_int(1, 20, 5);
+        });
+        REQUIRE(notification_calls == 2);
+        REQUIRE_INDICES(change.modifications, 2);
+        REQUIRE(change.insertions.empty());
+        REQUIRE(change.deletions.empty());
+        REQUIRE(results.size() == 100);
+    }
+
+    SECTION("modifying a matching row to no longer match marks that row as deleted") {
+        write([&] {
+            table->set_int(0, 10, 1);
+        });
+        REQUIRE(notification_calls == 2);
+        REQUIRE_INDICES(change.deletions, 1);
+        REQUIRE(change.insertions.empty());
+        REQUIRE(results.size() == 99);
+    }
+
+    SECTION("modifying a non-matching row to match marks that row as inserted") {
+        write([&] {
+            table->set_int(0, 5, 0);
+        });
+        REQUIRE(notification_calls == 2);
+        REQUIRE_INDICES(change.insertions, 1);
+        REQUIRE(change.modifications.empty());
+        REQUIRE(results.size() == 101);
+    }
+
+    SECTION("modifications to non-matching rows do not send notifications") {
+        write([&] {
+            table->set_int(0, 5, 2);
+            table->set_int(1, 6, 2);
+        });
+        REQUIRE(notification_calls == 1);
+    }
+
+    SECTION("appending matching rows marks them as inserted") {
+        write([&] {
+            table->add_empty_row(2);
+            table->set_int(0, 1001, 3);
+        });
+        REQUIRE(notification_calls == 2);
+        REQUIRE_INDICES(change.insertions, 100);
+        REQUIRE(results.size() == 101);
+        REQUIRE(results.get(100).get_index() == 1000);
+    }
+
+    SECTION("deleting a matching row marks that row as deleted") {
+        write([&] {
+            table->move_last_over(30);
+        });
+        REQUIRE(notification_calls == 2);
+        REQUIRE_INDICES(change.deletions, 3);
+        REQUIRE(change.insertions.empty());
+        REQUIRE(results.size() == 99);
+    }
+
+    SECTION("moving a matching row via deletion marks that row as moved") {
+        write([&] {
+            // Remove rows from the end until matching row 990 is the last one,
+            // then move it over a non-matching row
+            for (size_t i = 999; i > 990; --i)
+                table->move_last_over(i);
+            table->move_last_over(5);
+        });
+        REQUIRE(notification_calls == 2);
+        REQUIRE_MOVES(change, {99, 1});
+        REQUIRE(results.size() == 100);
+        REQUIRE(results.get(1).get_index() == 5);
+    }
+
+    SECTION("notifications are correct after the results are read") {
+        REQUIRE(results.size() == 100);
+        write([&] {
+            table->set_int(0, 0, 1);
+        });
+        REQUIRE(notification_calls == 2);
+        REQUIRE_INDICES(change.deletions, 0);
+
+        write([&] {
+            table->set_int(0, 1, 0);
+            table->set_int(0, 10, 1);
+        });
+        REQUIRE(notification_calls == 3);
+        REQUIRE_INDICES(change.insertions, 0);
+        REQUIRE_INDICES(change.deletions, 0);
+        REQUIRE(results.size() == 99);
+    }
+
+    SECTION("sorted notifications") {
+        token = {};
+        Results sorted(r, *config.schema->find("object"), table->where().equal(0, 0), {{1}, {false}});
+        token = sorted.add_notification_callback([&](CollectionChangeSet c, std::exception_ptr err) {
+            REQUIRE_FALSE(err);
+            change = c;
+            ++notification_calls;
+        });
+        advance_and_notify(*r);
+        REQUIRE(notification_calls == 2);
+
+        SECTION("modifying a row without changing its position marks it as modified") {
+            write([&] {
+                table->set_int(1, 980, 985);
+            });
+            REQUIRE(notification_calls == 3);
+            REQUIRE_INDICES(change.modifications, 1);
+            REQUIRE(change.moves.empty());
+        }
+
+        SECTION("modifying a row to change its position reports a move") {
+            write([&] {
+                table->set_int(1, 20, 2000);
+            });
+            REQUIRE(notification_calls == 3);
+            REQUIRE_MOVES(change, {97, 0});
+            REQUIRE(sorted.get(0).get_index() == 20);
+        }
+
+        SECTION("rows which start matching are inserted at their sorted position") {
+            write([&] {
+                table->set_int(0, 505, 0);
+                table->add_empty_row();
+                table->set_int(1, 1000, 1000);
+            });
+            REQUIRE(notification_calls == 3);
+            REQUIRE_INDICES(change.insertions, 0, 50);
+            REQUIRE(sorted.size() == 102);
+            REQUIRE(sorted.get(50).get_index() == 505);
+        }
+
+        SECTION("rows with equal values are ordered by row index") {
+            write([&] {
+                table->set_int(1, 500, 0);
+                table->set_int(1, 300, 0);
+            });
+            REQUIRE(notification_calls == 3);
+            REQUIRE_MOVES(change, {49, 99}, {69, 98});
+            REQUIRE(sorted.get(98).get_index() == 300);
+        }
+    }
+}
+
+TEST_CASE("Results::limit()") {
+    InMemoryTestFile config;
+    config.cache = false;
+    config.automatic_change_notifications = false;
+    config.schema = std::make_unique<Schema>(Schema{
+        {"object", "", {
+            {"value", PropertyTypeInt},
+            {"double", PropertyTypeDouble}
+        }}
+    });
+
+    auto r = Realm::get_shared_realm(config);
+    auto table = r->read_group()->get_table("class_object");
+
+    // Each value from 0 to 19 is in five rows, so the limit falls in the
+    // middle of the rows tied on 18
+    r->begin_transaction();
+    table->add_empty_row(100);
+    for (int i = 0; i < 100; ++i)
+        table->set_int(0, i, i % 20);
+    r->commit_transaction();
+
+    auto& object_schema = *config.schema->find("object");
+    Results results = Results(r, object_schema, table->where(), {{0}, {false}}).limit(7);
+
+    SECTION("only contains the first rows of the sorted results") {
+        REQUIRE(results.size() == 7);
+        REQUIRE(results.get(0).get_index() == 19);
+        REQUIRE(results.get(4).get_index() == 99);
+        REQUIRE(results.get(5).get_index() == 18);
+        REQUIRE(results.get(6).get_index() == 38);
+        REQUIRE(results.last()->get_index() == 38);
+        REQUIRE_THROWS(results.get(7));
+    }
+
+    SECTION("try_get() returns none past the limit") {
+        REQUIRE(results.try_get(6)->get_index() == 38);
+        REQUIRE_FALSE(results.try_get(7));
+    }
+
+    SECTION("NaN in the sort column does not exclude rows") {
+        r->begin_transaction();
+        for (int i = 0; i < 100; ++i)
+            table->set_double(1, i, i % 10 == 3 ? std::numeric_limits<double>::quiet_NaN() : i);
+        r->commit_transaction();
+
+        Results all = Results(r, object_schema, table->where(), {{1}, {true}});
+        Results limited = all.limit(5);
+        REQUIRE(limited.size() == 5);
+        for (size_t i = 0; i < 5; ++i)
+            REQUIRE(limited.get(i).get_index() == all.get(i).get_index());
+    }
+
+    SECTION("index_of() does not find rows after the limit") {
+        REQUIRE(results.index_of(38) == 6);
+        REQUIRE(results.index_of(58) == not_found);
+    }
+
+    SECTION("aggregates only include rows within the limit") {
+        REQUIRE(results.sum(0)->get_int() == 19 * 5 + 18 * 2);
+        REQUIRE(results.min(0)->get_int() == 18);
+        REQUIRE(results.max(0)->get_int() == 19);
+    }
+
+    SECTION("unsorted results contain the first matching rows") {
+        Results unsorted = Results(r, object_schema, table->where().greater(0, 10)).limit(3);
+        REQUIRE(unsorted.size() == 3);
+        REQUIRE(unsorted.get(2).get_index() == 13);
+        REQUIRE(unsorted.sum(0)->get_int() == 11 + 12 + 13);
+    }
+
+    SECTION("filter() applies before the limit") {
+        auto filtered = results.filter(table->where().less(0, 19));
+        REQUIRE(filtered.size() == 7);
+        REQUIRE(filtered.get(0).get_index() == 18);
+        REQUIRE(filtered.get(6).get_index() == 37);
+    }
+
+    SECTION("clear() only deletes rows within the limit") {
+        r->begin_transaction();
+        results.clear();
+        r->commit_transaction();
+        REQUIRE(table->size() == 93);
+        REQUIRE(table->where().equal(0, 18).count() == 3);
+        REQUIRE(results.size() == 7);
+        REQUIRE(results.get(0).get_index() == table->where().equal(0, 18).find());
+    }
+
+    SECTION("results are updated when rows move into the limit") {
+        REQUIRE(results.get(6).get_index() == 38);
+        r->begin_transaction();
+        table->set_int(0, 0, 20);
+        r->commit_transaction();
+        REQUIRE(results.size() == 7);
+        REQUIRE(results.get(0).get_index() == 0);
+        REQUIRE(results.get(6).get_index() == 18);
+    }
+
+    SECTION("notifications") {
+        int notification_calls = 0;
+        CollectionChangeSet change;
+        auto token = results.add_notification_callback([&](CollectionChangeSet c, std::exception_ptr err) {
+            REQUIRE_FALSE(err);
+            change = c;
+            ++notification_calls;
+        });
+        advance_and_notify(*r);
+
+        SECTION("a row sorting before the limit pushes the last row out") {
+            r->begin_transaction();
+            table->set_int(0, 0, 20);
+            r->commit_transaction();
+            advance_and_notify(*r);
+
+            REQUIRE(notification_calls == 2);
+            REQUIRE_INDICES(change.insertions, 0);
+            REQUIRE_INDICES(change.deletions, 6);
+        }
+
+        SECTION("changes to rows after the limit are not reported") {
+            r->begin_transaction();
+            table->set_int(0, 58, 0);
+            table->set_int(0, 17, 0);
+            r->commit_transaction();
+            advance_and_notify(*r);
+
+            REQUIRE(notification_calls == 1);
+        }
+    }
+}
+
+TEST_CASE("Results::window()") {
+    InMemoryTestFile config;
+    config.cache = false;
+    config.automatic_change_notifications = false;
+    config.schema = std::make_unique<Schema>(Schema{
+        {"object", "", {
+            {"value", PropertyTypeInt}
+        }}
+    });
+
+    auto r = Realm::get_shared_realm(config);
+    auto table = r->read_group()->get_table("class_object");
+
+    r->begin_transaction();
+    table->add_empty_row(100);
+    for (int i = 0; i < 100; ++i)
+        table->set_int(0, i, i % 20);
+    r->commit_transaction();
+
+    // The rows with 19 come first, followed by 18, 38, 58, 78 and 98 with 18
+    auto& object_schema = *config.schema->find("object");
+    Results results = Results(r, object_schema, table->where(), {{0}, {false}}).window(5, 4);
+
+    SECTION("indices are relative to the start of the window") {
+        REQUIRE(results.size() == 4);
+        REQUIRE(results.get(0).get_index() == 18);
+        REQUIRE(results.get(3).get_index() == 78);
+        REQUIRE(results.first()->get_index() == 18);
+        REQUIRE(results.last()->get_index() == 78);
+        REQUIRE_THROWS(results.get(4));
+    }
+
+    SECTION("index_of() does not find rows outside the window") {
+        REQUIRE(results.index_of(18) == 0);
+        REQUIRE(results.index_of(78) == 3);
+        REQUIRE(results.index_of(19) == not_found);
+        REQUIRE(results.index_of(98) == not_found);
+    }
+
+    SECTION("aggregates only include rows within the window") {
+        REQUIRE(results.sum(0)->get_int() == 18 * 4);
+        REQUIRE(results.max(0)->get_int() == 18);
+    }
+
+    SECTION("unsorted windows skip the first matching rows") {
+        Results unsorted = Results(r, object_schema, table->where()).window(10, 3);
+        REQUIRE(unsorted.size() == 3);
+        REQUIRE(unsorted.get(0).get_index() == 10);
+        REQUIRE(unsorted.get(2).get_index() == 12);
+    }
+
+    SECTION("windows extending past the end of the results are truncated") {
+        REQUIRE(Results(r, object_schema, table->where()).window(98, 5).size() == 2);
+        REQUIRE(Results(r, object_schema, table->where()).window(200, 5).size() == 0);
+    }
+
+    SECTION("windows of windows are relative to the outer window") {
+        auto inner = results.window(1, 10);
+        REQUIRE(inner.size() == 3);
+        REQUIRE(inner.get(0).get_index() == 38);
+        REQUIRE(results.limit(2).get(1).get_index() == 38);
+    }
+
+    SECTION("notifications") {
+        int notification_calls = 0;
+        CollectionChangeSet change;
+        auto token = results.add_notification_callback([&](CollectionChangeSet c, std::exception_ptr err) {
+            REQUIRE_FALSE(err);
+            change = c;
+            ++notification_calls;
+        });
+        advance_and_notify(*r);
+
+        SECTION("inserting a row before the window shifts rows into and out of it") {
+            r->begin_transaction();
+            table->set_int(0, 0, 20);
+            r->commit_transaction();
+            advance_and_notify(*r);
+
+            REQUIRE(notification_calls == 2);
+            REQUIRE_INDICES(change.insertions, 0);
+            REQUIRE_INDICES(change.deletions, 3);
+        }
+
+        SECTION("modifying a row in the window reports a window-relative index") {
+            r->begin_transaction();
+            table->set_int(0, 58, 5);
+            r->commit_transaction();
+            advance_and_notify(*r);
+
+            REQUIRE(notification_calls == 2);
+            REQUIRE_INDICES(change.deletions, 2);
+            REQUIRE_INDICES(change.insertions, 3);
+        }
+
+        SECTION("changes outside of the window are not reported") {
+            r->begin_transaction();
+            table->set_int(0, 97, 18);
+            table->set_int(0, 17, 0);
+            r->commit_transaction();
+            advance_and_notify(*r);
+
+            REQUIRE(notification_calls == 1);
+        }
+    }
+}
+
+TEST_CASE("Results::aggregate_many()") {
+    InMemoryTestFile config;
+    config.cache = false;
+    config.automatic_change_notifications = false;
+    config.schema = std::make_unique<Schema>(Schema{
+        {"object", "", {
+            {"int", PropertyTypeInt},
+            {"double", PropertyTypeDouble},
+            {"date", PropertyTypeDate},
+            {"string", PropertyTypeString}
+        }}
+    });
+
+    auto r = Realm::get_shared_realm(config);
+    auto table = r->read_group()->get_table("class_object");
+
+    r->begin_transaction();
+    table->add_empty_row(3000);
+    for (int i = 0; i < 3000; ++i) {
+        table->set_int(0, i, i);
+        table->set_double(1, i, i / 2.0);
+        table->set_datetime(2, i, DateTime(1000 + i));
+    }
+    r->commit_transaction();
+
+    using Op = Results::AggregateOp;
+    auto& object_schema = *config.schema->find("object");
+
+    SECTION("matches the individual aggregate functions") {
+        Results results(r, object_schema, table->where().greater(0, 100));
+        auto values = results.aggregate_many({
+            {0, Op::Count}, {0, Op::Min}, {0, Op::Max}, {0, Op::Sum}, {0, Op::Average},
+            {1, Op::Min}, {1, Op::Max}, {1, Op::Sum}, {1, Op::Average},
+            {2, Op::Min}, {2, Op::Max}
+        });
+        REQUIRE(values.size() == 11);
+        REQUIRE(values[0]->get_int() == 2899);
+        REQUIRE(values[1]->get_int() == results.min(0)->get_int());
+        REQUIRE(values[2]->get_int() == results.max(0)->get_int());
+        REQUIRE(values[3]->get_int() == results.sum(0)->get_int());
+        REQUIRE(values[4]->get_double() == results.average(0)->get_double());
+        REQUIRE(values[5]->get_double() == results.min(1)->get_double());
+        REQUIRE(values[6]->get_double() == results.max(1)->get_double());
+        REQUIRE(values[7]->get_double() == results.sum(1)->get_double());
+        REQUIRE(values[8]->get_double() == results.average(1)->get_double());
+        REQUIRE(values[9]->get_datetime().get_datetime() == 1101);
+        REQUIRE(values[10]->get_datetime().get_datetime() == 3999);
+    }
+
+    SECTION("only includes rows in the window") {
+        Results results = Results(r, object_schema, table->where(), {{0}, {false}}).window(10, 5);
+        auto values = results.aggregate_many({{0, Op::Count}, {0, Op::Min}, {0, Op::Max}});
+        REQUIRE(values[0]->get_int() == 5);
+        REQUIRE(values[1]->get_int() == 2985);
+        REQUIRE(values[2]->get_int() == 2989);
+    }
+
+    SECTION("works on Results backed directly by a table") {
+        Results results(r, object_schema, *table);
+        auto values = results.aggregate_many({
+            {0, Op::Sum}, {0, Op::Count}, {0, Op::Min}, {0, Op::Max}, {0, Op::Average},
+            {1, Op::Min}, {1, Op::Max}, {1, Op::Sum}, {1, Op::Average},
+            {2, Op::Count}, {2, Op::Min}, {2, Op::Max}
+        });
+        REQUIRE(values[0]->get_int() == 2999 * 3000 / 2);
+        REQUIRE(values[1]->get_int() == 3000);
+        REQUIRE(values[2]->get_int() == 0);
+        REQUIRE(values[3]->get_int() == 2999);
+        REQUIRE(values[4]->get_double() == results.average(0)->get_double());
+        REQUIRE(values[5]->get_double() == 0);
+        REQUIRE(values[6]->get_double() == 1499.5);
+        REQUIRE(values[7]->get_double() == results.sum(1)->get_double());
+        REQUIRE(values[8]->get_double() == results.average(1)->get_double());
+        REQUIRE(values[9]->get_int() == 3000);
+        REQUIRE(values[10]->get_datetime().get_datetime() == 1000);
+        REQUIRE(values[11]->get_datetime().get_datetime() == 3999);
+    }
+
+    SECTION("returns none for min/max/average of an empty table") {
+        r->begin_transaction();
+        table->clear();
+        r->commit_transaction();
+        Results results(r, object_schema, *table);
+        auto values = results.aggregate_many({{0, Op::Min}, {0, Op::Average}, {0, Op::Sum}, {2, Op::Max}, {1, Op::Count}});
+        REQUIRE_FALSE(values[0]);
+        REQUIRE_FALSE(values[1]);
+        REQUIRE(values[2]->get_int() == 0);
+        REQUIRE_FALSE(values[3]);
+        REQUIRE(values[4]->get_int() == 0);
+    }
+
+    SECTION("returns none for min/max/average with no rows, and zero for sum and count") {
+        Results results(r, object_schema, table->where().greater(0, 5000));
+        auto values = results.aggregate_many({{0, Op::Min}, {0, Op::Max}, {0, Op::Average}, {0, Op::Sum}, {1, Op::Count}});
+        REQUIRE_FALSE(values[0]);
+        REQUIRE_FALSE(values[1]);
+        REQUIRE_FALSE(values[2]);
+        REQUIRE(values[3]->get_int() == 0);
+        REQUIRE(values[4]->get_int() == 0);
+    }
+
+    SECTION("throws for unsupported columns before computing anything") {
+        Results results(r, object_schema, *table);
+        REQUIRE_THROWS_AS(results.aggregate_many({{0, Op::Sum}, {2, Op::Sum}}), Results::UnsupportedColumnTypeException);
+        REQUIRE_THROWS_AS(results.aggregate_many({{3, Op::Min}}), Results::UnsupportedColumnTypeException);
+        REQUIRE_THROWS_AS(results.aggregate_many({{4, Op::Min}}), Results::OutOfBoundsIndexException);
+    }
+}
+
 TEST_CASE("Async Results error handling") {
     InMemoryTestFile config;
     config.cache = false;
@@ -520,3 +1060,329 @@ TEST_CASE("Async Results error handling") {
 
     }
 }
+
+TEST_CASE("Results parallel evaluation") {
+    InMemoryTestFile config;
+    config.cache = false;
+    config.automatic_change_notifications = false;
+    config.schema = std::make_unique<Schema>(Schema{
+        {"object", "", {
+            {"value", PropertyTypeInt}
+        }}
+    });
+
+    auto r = Realm::get_shared_realm(config);
+    auto table = r->read_group()->get_table("class_object");
+
+    // enough rows for the table to be split into several ranges
+    const size_t row_count = _impl::ParallelQueryExecutor::min_rows_per_range * 3;
+    r->begin_transaction();
+    table->add_empty_row(row_count);
+    for (size_t i = 0; i < row_count; ++i)
+        table->set_int(0, i, i % 3);
+    r->commit_transaction();
+
+    Results results(r, *config.schema->find("object"), table->where().equal(0, 1));
+
+    SECTION("count matches serial evaluation") {
+        REQUIRE(results.size() == row_count / 3);
+        results.set_parallel_evaluation(true);
+        REQUIRE(results.size() == row_count / 3);
+    }
+
+    SECTION("row indices are in table order") {
+        std::vector<size_t> expected;
+        for (size_t i = 1; i < row_count; i += 3)
+            expected.push_back(i);
+        REQUIRE(results.find_all_row_indices_parallel() == expected);
+    }
+
+    SECTION("row indices of sorted results are in sorted order") {
+        Results sorted(r, *config.schema->find("object"), table->where().less(0, 2), {{0}, {false}});
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < sorted.size(); ++i)
+            expected.push_back(sorted.get(i).get_index());
+        REQUIRE_FALSE(std::is_sorted(expected.begin(), expected.end()));
+        REQUIRE(sorted.find_all_row_indices_parallel() == expected);
+    }
+
+    SECTION("row indices of limited and windowed results only include their rows") {
+        REQUIRE(results.limit(3).find_all_row_indices_parallel() == (std::vector<size_t>{1, 4, 7}));
+        REQUIRE(results.window(2, 2).find_all_row_indices_parallel() == (std::vector<size_t>{7, 10}));
+        REQUIRE(results.window(row_count, 2).find_all_row_indices_parallel().empty());
+    }
+
+    SECTION("queries see the version of the calling thread") {
+        auto r2 = Realm::get_shared_realm(config);
+        r2->begin_transaction();
+        r2->read_group()->get_table("class_object")->clear();
+        r2->commit_transaction();
+
+        results.set_parallel_evaluation(true);
+        REQUIRE(results.size() == row_count / 3);
+    }
+
+    SECTION("queries in a write transaction include uncommitted rows") {
+        results.set_parallel_evaluation(true);
+        r->begin_transaction();
+        size_t row = table->add_empty_row(2);
+        table->set_int(0, row, 1);
+        table->set_int(0, row + 1, 1);
+        REQUIRE(results.size() == row_count / 3 + 2);
+        auto rows = results.find_all_row_indices_parallel();
+        REQUIRE(rows.size() == row_count / 3 + 2);
+        REQUIRE(rows.back() == row + 1);
+        r->cancel_transaction();
+    }
+}
+
+
+TEST_CASE("Results notifications on multiple threads") {
+    InMemoryTestFile config;
+    config.cache = false;
+    config.automatic_change_notifications = false;
+    config.notifier_threads = 4;
+    config.schema = std::make_unique<Schema>(Schema{
+        {"object", "", {
+            {"value", PropertyTypeInt}
+        }}
+    });
+
+    auto r = Realm::get_shared_realm(config);
+    auto table = r->read_group()->get_table("class_object");
+
+    r->begin_transaction();
+    table->add_empty_row(10);
+    for (int i = 0; i < 10; ++i)
+        table->set_int(0, i, i);
+    r->commit_transaction();
+
+    // more notifiers than threads, each matching a different single row
+    const size_t notifier_count = 10;
+    // reserved up front as the notifiers point at the Results they're for
+    std::vector<Results> results;
+    results.reserve(notifier_count);
+    std::vector<NotificationToken> tokens;
+    std::vector<CollectionChangeSet> changes(notifier_count);
+    std::vector<int> notification_calls(notifier_count);
+    for (size_t i = 0; i < notifier_count; ++i) {
+        results.push_back(Results(r, *config.schema->find("object"), table->where().equal(0, int64_t(i))));
+        tokens.push_back(results.back().add_notification_callback([&, i](CollectionChangeSet c, std::exception_ptr err) {
+            REQUIRE_FALSE(err);
+            changes[i] = c;
+            ++notification_calls[i];
+        }));
+    }
+
+    advance_and_notify(*r);
+    for (size_t i = 0; i < notifier_count; ++i) {
+        REQUIRE(notification_calls[i] == 1);
+        REQUIRE(results[i].size() == 1);
+    }
+
+    SECTION("each notifier reports its own changes") {
+        r->begin_transaction();
+        table->set_int(0, 3, 3);
+        table->set_int(0, 5, 50);
+        r->commit_transaction();
+        advance_and_notify(*r);
+
+        for (size_t i = 0; i < notifier_count; ++i)
+            REQUIRE(notification_calls[i] == (i == 3 || i == 5 ? 2 : 1));
+        REQUIRE_INDICES(changes[3].modifications, 0);
+        REQUIRE_INDICES(changes[5].deletions, 0);
+        REQUIRE(results[5].size() == 0);
+    }
+
+    SECTION("notifiers keep working across several commits") {
+        for (int i = 0; i < 3; ++i) {
+            r->begin_transaction();
+            table->set_int(0, table->add_empty_row(), 7);
+            r->commit_transaction();
+            advance_and_notify(*r);
+        }
+        REQUIRE(notification_calls[7] == 4);
+        REQUIRE(results[7].size() == 4);
+        REQUIRE_INDICES(changes[7].insertions, 3);
+    }
+}
+
+TEST_CASE("Results notification rate limiting") {
+    using namespace std::chrono;
+
+    InMemoryTestFile config;
+    config.cache = false;
+    config.automatic_change_notifications = false;
+    config.schema = std::make_unique<Schema>(Schema{
+        {"object", "", {
+            {"value", PropertyTypeInt}
+        }}
+    });
+
+    SECTION("runs are at least min_interval apart") {
+        config.notification_rate_limit.min_interval = milliseconds(50);
+    }
+    SECTION("max_latency caps the wait") {
+        config.notification_rate_limit.min_interval = seconds(60);
+        config.notification_rate_limit.max_latency = milliseconds(50);
+    }
+
+    auto r = Realm::get_shared_realm(config);
+    auto table = r->read_group()->get_table("class_object");
+    Results results(r, *config.schema->find("object"), table->where());
+
+    int notification_calls = 0;
+    CollectionChangeSet change;
+    auto token = results.add_notification_callback([&](CollectionChangeSet c, std::exception_ptr err) {
+        REQUIRE_FALSE(err);
+        change = c;
+        ++notification_calls;
+    });
+    advance_and_notify(*r);
+    REQUIRE(notification_calls == 1);
+
+    // Both commits are delivered by the next run, which has to wait for the
+    // interval since the initial run to pass
+    for (int i = 0; i < 2; ++i) {
+        r->begin_transaction();
+        table->add_empty_row();
+        r->commit_transaction();
+    }
+    auto start = steady_clock::now();
+    advance_and_notify(*r);
+    auto elapsed = steady_clock::now() - start;
+
+    REQUIRE(notification_calls == 2);
+    REQUIRE_INDICES(change.insertions, 0, 1);
+    REQUIRE(elapsed >= milliseconds(40));
+    REQUIRE(elapsed < seconds(30));
+}
+
+TEST_CASE("Results notification rate limiting with continuous commits") {
+    using namespace std::chrono;
+
+    InMemoryTestFile config;
+    config.cache = false;
+    config.automatic_change_notifications = false;
+    config.schema = std::make_unique<Schema>(Schema{
+        {"object", "", {
+            {"value", PropertyTypeInt}
+        }}
+    });
+
+    // the shortest time the limit allows between two runs
+    milliseconds min_gap;
+    SECTION("min_interval is enforced while commits keep arriving") {
+        config.notification_rate_limit.min_interval = milliseconds(30);
+        min_gap = milliseconds(30);
+    }
+    SECTION("a shorter max_latency wins over min_interval") {
+        config.notification_rate_limit.min_interval = seconds(60);
+        config.notification_rate_limit.max_latency = milliseconds(20);
+        min_gap = milliseconds(20);
+    }
+
+    auto r = Realm::get_shared_realm(config);
+    auto table = r->read_group()->get_table("class_object");
+    Results results(r, *config.schema->find("object"), table->where());
+
+    int notification_calls = 0;
+    auto token = results.add_notification_callback([&](CollectionChangeSet, std::exception_ptr err) {
+        REQUIRE_FALSE(err);
+        ++notification_calls;
+    });
+    advance_and_notify(*r);
+    REQUIRE(notification_calls == 1);
+
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        auto r2 = Realm::get_shared_realm(config);
+        auto table2 = r2->read_group()->get_table("class_object");
+        while (!done) {
+            r2->begin_transaction();
+            table2->add_empty_row();
+            r2->commit_transaction();
+        }
+    });
+
+    const int runs = 5;
+    auto start = steady_clock::now();
+    for (int i = 0; i < runs; ++i)
+        advance_and_notify(*r);
+    auto elapsed = steady_clock::now() - start;
+    done = true;
+    writer.join();
+
+    REQUIRE(notification_calls > 1);
+    REQUIRE(elapsed >= min_gap * (runs - 1));
+    REQUIRE(elapsed < seconds(30));
+}
+
+TEST_CASE("Results notification priorities") {
+    InMemoryTestFile config;
+    config.cache = false;
+    config.automatic_change_notifications = false;
+    config.schema = std::make_unique<Schema>(Schema{
+        {"object", "", {
+            {"value", PropertyTypeInt}
+        }}
+    });
+
+    auto r = Realm::get_shared_realm(config);
+    auto table = r->read_group()->get_table("class_object");
+    r->begin_transaction();
+    table->add_empty_row(5);
+    r->commit_transaction();
+
+    Results background(r, *config.schema->find("object"), table->where());
+    Results normal(r, *config.schema->find("object"), table->where());
+    Results high(r, *config.schema->find("object"), table->where());
+
+    // registered lowest priority first, so that the order of the calls can
+    // only come from the priorities
+    std::vector<std::string> calls;
+    CollectionChangeSet background_change, high_change;
+    auto background_token = background.add_notification_callback([&](CollectionChangeSet c, std::exception_ptr) {
+        background_change = c;
+        calls.push_back("background");
+    }, NotificationPriority::Background);
+    auto normal_token = normal.add_notification_callback([&](CollectionChangeSet, std::exception_ptr) {
+        calls.push_back("normal");
+    });
+    auto high_token = high.add_notification_callback([&](CollectionChangeSet c, std::exception_ptr) {
+        high_change = c;
+        calls.push_back("high");
+    }, NotificationPriority::High);
+
+    advance_and_notify(*r);
+    REQUIRE(calls == (std::vector<std::string>{"high", "normal", "background"}));
+
+    SECTION("each priority group sees the same changes") {
+        calls.clear();
+        r->begin_transaction();
+        table->move_last_over(4);
+        r->commit_transaction();
+        advance_and_notify(*r);
+
+        REQUIRE(calls == (std::vector<std::string>{"high", "normal", "background"}));
+        REQUIRE_INDICES(high_change.deletions, 4);
+        REQUIRE_INDICES(background_change.deletions, 4);
+        REQUIRE(high.size() == 4);
+        REQUIRE(background.size() == 4);
+    }
+
+    SECTION("a notifier uses the highest priority of its callbacks") {
+        auto token = background.add_notification_callback([&](CollectionChangeSet, std::exception_ptr) {
+            calls.push_back("raised");
+        }, NotificationPriority::High);
+        calls.clear();
+        r->begin_transaction();
+        table->add_empty_row();
+        r->commit_transaction();
+        advance_and_notify(*r);
+
+        // within a group the notifiers keep the order of the previous run,
+        // where high came first
+        REQUIRE(calls == (std::vector<std::string>{"high", "background", "raised", "normal"}));
+    }
+}
@@ -946,4 +946,98 @@ TEST_CASE("Transaction log parsing") {
             REQUIRE(changes.modifications.empty());
         }
     }
+
+    SECTION("decoded changesets") {
+        config.schema = std::make_unique<Schema>(Schema{
+            {"table", "", {
+                {"value", PropertyTypeInt}
+            }},
+        });
+
+        auto r = Realm::get_shared_realm(config);
+        auto& table = *r->read_group()->get_table("class_table");
+
+        r->begin_transaction();
+        table.add_empty_row(10);
+        r->commit_transaction();
+
+        auto decoder_history = make_client_history(config.path);
+        SharedGroup decoder(*decoder_history, SharedGroup::durability_MemOnly);
+        decoder.begin_read();
+        auto replayer_history = make_client_history(config.path);
+        SharedGroup replayer(*replayer_history, SharedGroup::durability_MemOnly);
+        replayer.begin_read();
+
+        auto write = [&](auto&& f) {
+            r->begin_transaction();
+            f();
+            r->commit_transaction();
+        };
+        auto decode = [&](_impl::TransactionChangeInfo* info, size_t max_bytes = 1024 * 1024) {
+            return _impl::transaction::advance_and_decode(decoder, info, SharedGroup::VersionID{}, max_bytes);
+        };
+        auto make_info = [] {
+            _impl::TransactionChangeInfo info;
+            info.table_modifications_needed = {false, false, true};
+            info.table_moves_needed = {false, false, true};
+            return info;
+        };
+
+        SECTION("replaying produces the same change information as parsing") {
+            write([&] {
+                table.set_int(0, 1, 2);
+                table.add_empty_row();
+            });
+            write([&] { table.set_int(0, 5, 5); });
+
+            auto parsed = make_info();
+            _impl::DecodedChangesets changesets{decode(&parsed)};
+            REQUIRE(changesets[0]);
+
+            auto replayed = make_info();
+            _impl::transaction::advance(replayer, replayed, decoder.get_version_of_current_transaction(), &changesets);
+            REQUIRE(replayer.get_version_of_current_transaction() == decoder.get_version_of_current_transaction());
+
+            for (auto info : {&parsed, &replayed}) {
+                REQUIRE(info->tables.size() == 3);
+                REQUIRE_INDICES(info->tables[2].insertions, 10);
+                REQUIRE_INDICES(info->tables[2].modifications, 1, 5);
+            }
+        }
+
+        SECTION("changesets which don't start at the current version are not used") {
+            write([&] { table.set_int(0, 1, 2); });
+            decode(nullptr);
+            write([&] { table.set_int(0, 5, 5); });
+            _impl::DecodedChangesets changesets{decode(nullptr)};
+
+            auto info = make_info();
+            _impl::transaction::advance(replayer, info, decoder.get_version_of_current_transaction(), &changesets);
+            REQUIRE(replayer.get_version_of_current_transaction() == decoder.get_version_of_current_transaction());
+            REQUIRE_INDICES(info.tables[2].modifications, 1, 5);
+        }
+
+        SECTION("changes too large for the budget are not decoded but are still observed") {
+            write([&] {
+                for (size_t i = 0; i < 10; ++i)
+                    table.set_int(0, i, 1);
+            });
+
+            auto info = make_info();
+            REQUIRE_FALSE(decode(&info, 64));
+            REQUIRE_INDICES(info.tables[2].modifications, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9);
+        }
+
+        SECTION("advancing with no changes does not produce a changeset") {
+            REQUIRE_FALSE(decode(nullptr));
+        }
+
+        SECTION("schema changes are validated when the changes are replayed") {
+            write([&] { table.add_column(type_String, "new col"); });
+
+            _impl::DecodedChangesets changesets;
+            REQUIRE_NOTHROW(changesets.push_back(decode(nullptr)));
+            REQUIRE_THROWS(_impl::transaction::advance(replayer, nullptr, decoder.get_version_of_current_transaction(), &changesets));
+        }
+    }
 }
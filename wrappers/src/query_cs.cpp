@@ -21,12 +21,193 @@
 #include "marshalling.hpp"
 #include "error_handling.hpp"
 #include "realm_export_decls.hpp"
+#include "wrapper_exceptions.hpp"
 #include "object-store/src/shared_realm.hpp"
 #include "object-store/src/schema.hpp"
+#include "object-store/src/object_store.hpp"
+#include "object-store/src/parser/parser.hpp"
+#include "object-store/src/parser/query_builder.hpp"
+#include <list>
+#include <mutex>
+#include <unordered_map>
 
 using namespace realm;
 using namespace realm::binding;
 
+/// One argument ($0, $1, ...) for a parsed query, as laid out by the managed side.
+/// type is the DataType of the value, or null_argument_type for null, and decides
+/// which of the value fields are used.
+struct QueryArgument {
+    static const size_t null_argument_type = size_t(-1);
+
+    size_t type;
+    int64_t int_value; // bool, int, datetime (seconds) and the row index for links
+    double double_value; // float and double
+    uint16_t* string_value; // UTF-16 for strings, raw bytes for binary
+    size_t string_len; // in 16 bit characters for strings, bytes for binary
+};
+
+/// A predicate which has been parsed once and can then be applied with any number
+/// of different sets of arguments
+struct PreparedQuery {
+    std::string object_type;
+    parser::Predicate predicate;
+};
+
+namespace {
+
+class QueryArgumentBuffer : public query_builder::Arguments {
+public:
+    QueryArgumentBuffer(const QueryArgument* arguments, size_t count) : m_arguments(arguments), m_count(count) {}
+
+    bool bool_for_argument(size_t argument_index) override
+    {
+        return argument_of_type(argument_index, type_Bool, "bool").int_value != 0;
+    }
+
+    long long long_for_argument(size_t argument_index) override
+    {
+        return argument_of_type(argument_index, type_Int, "int").int_value;
+    }
+
+    float float_for_argument(size_t argument_index) override
+    {
+        return float(numeric_argument(argument_index));
+    }
+
+    double double_for_argument(size_t argument_index) override
+    {
+        return numeric_argument(argument_index);
+    }
+
+    std::string string_for_argument(size_t argument_index) override
+    {
+        auto& argument = argument_of_type(argument_index, type_String, "string");
+        return Utf16StringAccessor(argument.string_value, argument.string_len).to_string();
+    }
+
+    std::string binary_for_argument(size_t argument_index) override
+    {
+        auto& argument = argument_of_type(argument_index, type_Binary, "binary");
+        return std::string(reinterpret_cast<const char*>(argument.string_value), argument.string_len);
+    }
+
+    DateTime datetime_for_argument(size_t argument_index) override
+    {
+        return DateTime(argument_of_type(argument_index, type_DateTime, "date").int_value);
+    }
+
+    size_t object_index_for_argument(size_t argument_index) override
+    {
+        return size_t(argument_of_type(argument_index, type_Link, "object").int_value);
+    }
+
+    bool is_argument_null(size_t argument_index) override
+    {
+        return argument_at(argument_index).type == QueryArgument::null_argument_type;
+    }
+
+private:
+    const QueryArgument* m_arguments;
+    size_t m_count;
+
+    const QueryArgument& argument_at(size_t argument_index)
+    {
+        if (argument_index >= m_count)
+            throw IndexOutOfRangeException("Query argument", argument_index, m_count);
+        return m_arguments[argument_index];
+    }
+
+    const QueryArgument& argument_of_type(size_t argument_index, DataType type, const char* type_name)
+    {
+        auto& argument = argument_at(argument_index);
+        if (argument.type != size_t(type))
+            throw std::invalid_argument("Query argument $" + util::to_string(argument_index) + " must be of type " + type_name);
+        return argument;
+    }
+
+    // floating point columns can be compared with any kind of number
+    double numeric_argument(size_t argument_index)
+    {
+        auto& argument = argument_at(argument_index);
+        switch (argument.type) {
+            case type_Int:
+                return double(argument.int_value);
+            case type_Float:
+            case type_Double:
+                return argument.double_value;
+            default:
+                throw std::invalid_argument("Query argument $" + util::to_string(argument_index) + " must be a number");
+        }
+    }
+};
+
+// Builds a new Query over object_type in realm from an already parsed predicate
+Query* create_query(SharedRealm& realm, std::string const& object_type, parser::Predicate const& predicate,
+                    const QueryArgument* arguments, size_t argument_count)
+{
+    auto& schema = realm->config().schema;
+    if (!schema)
+        throw std::logic_error("Realm was opened without a schema");
+
+    TableRef table = ObjectStore::table_for_object_type(realm->read_group(), object_type);
+    if (!table)
+        throw std::invalid_argument("Object type '" + object_type + "' is not in the Realm");
+
+    Query query = table->where();
+    QueryArgumentBuffer args(arguments, argument_count);
+    query_builder::apply_predicate(query, predicate, args, *schema, object_type);
+    return new Query(std::move(query));
+}
+
+// Least recently used cache of parsed predicates, keyed on the predicate text. The parsed
+// form doesn't depend on the schema (names are only resolved by apply_predicate) so
+// entries never need to be invalidated.
+class PredicateCache {
+public:
+    static PredicateCache& shared()
+    {
+        static PredicateCache cache;
+        return cache;
+    }
+
+    std::shared_ptr<const parser::Predicate> get(std::string const& text)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_index.find(text);
+            if (it != m_index.end()) {
+                m_entries.splice(m_entries.begin(), m_entries, it->second);
+                return it->second->second;
+            }
+        }
+
+        // parse outside of the lock, as it's by far the slowest part
+        auto predicate = std::make_shared<const parser::Predicate>(parser::parse(text));
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_index.count(text))
+            return predicate;
+        m_entries.emplace_front(text, predicate);
+        m_index[text] = m_entries.begin();
+        if (m_entries.size() > max_entries) {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+        }
+        return predicate;
+    }
+
+private:
+    static const size_t max_entries = 128;
+
+    using Entry = std::pair<std::string, std::shared_ptr<const parser::Predicate>>;
+    std::mutex m_mutex;
+    std::list<Entry> m_entries; // most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+};
+
+} // anonymous namespace
+
 extern "C" {
 
 REALM_EXPORT void query_destroy(Query* query_ptr)
@@ -52,6 +233,17 @@ REALM_EXPORT Row* query_find(Query * query_ptr, size_t begin_at_table_row)
     });
 }
 
+// Handle-free alternative to query_find: returns the index of the next matching row, or npos
+REALM_EXPORT size_t query_find_row_index(Query * query_ptr, size_t begin_at_table_row)
+{
+    return handle_errors([&]() -> size_t {
+        if (begin_at_table_row >= query_ptr->get_table()->size())
+            return not_found;
+
+        return query_ptr->find(begin_at_table_row);
+    });
+}
+
 REALM_EXPORT size_t query_count(Query * query_ptr)
 {
     return handle_errors([&]() {
@@ -320,4 +512,46 @@ REALM_EXPORT void query_datetime_seconds_greater_equal(Query* query_ptr, size_t
     });
 }
 
+// Parses predicate (in the NSPredicate-like syntax of the object store's query parser) once, so that
+// it can be run any number of times with different $0..$n arguments by prepared_query_execute.
+REALM_EXPORT PreparedQuery* prepared_query_create(uint16_t* object_type, size_t object_type_len, uint16_t* predicate, size_t predicate_len)
+{
+    return handle_errors([&]() {
+        Utf16StringAccessor type_str(object_type, object_type_len);
+        Utf16StringAccessor predicate_str(predicate, predicate_len);
+        return new PreparedQuery{type_str.to_string(), parser::parse(predicate_str.to_string())};
+    });
+}
+
+REALM_EXPORT void prepared_query_destroy(PreparedQuery* prepared_query_ptr)
+{
+    handle_errors([&]() {
+        delete prepared_query_ptr;
+    });
+}
+
+// Builds a new Query over the prepared query's object type in realm, with the arguments substituted.
+// The Query is owned by the caller and freed with query_destroy, just like one from table_where.
+REALM_EXPORT Query* prepared_query_execute(PreparedQuery* prepared_query_ptr, SharedRealm* realm,
+                                           const QueryArgument* arguments, size_t argument_count)
+{
+    return handle_errors([&]() {
+        return create_query(*realm, prepared_query_ptr->object_type, prepared_query_ptr->predicate, arguments, argument_count);
+    });
+}
+
+// One-shot version of prepared_query_create + prepared_query_execute. Parsed predicates are kept in
+// a process wide cache, so running the same predicate text again skips the parser.
+REALM_EXPORT Query* query_create_from_string(SharedRealm* realm, uint16_t* object_type, size_t object_type_len,
+                                             uint16_t* predicate, size_t predicate_len,
+                                             const QueryArgument* arguments, size_t argument_count)
+{
+    return handle_errors([&]() {
+        Utf16StringAccessor type_str(object_type, object_type_len);
+        Utf16StringAccessor predicate_str(predicate, predicate_len);
+        auto parsed = PredicateCache::shared().get(predicate_str.to_string());
+        return create_query(*realm, type_str.to_string(), *parsed, arguments, argument_count);
+    });
+}
+
 }   // extern "C"
@@ -18,9 +18,12 @@
 
 #include <realm.hpp>
 #include "error_handling.hpp"
+#include "live_aggregate.hpp"
 #include "marshalling.hpp"
+#include "notifications_cs.hpp"
 #include "realm_export_decls.hpp"
 #include "results.hpp"
+#include "wrapper_exceptions.hpp"
 
 using namespace realm;
 using namespace realm::binding;
@@ -39,6 +42,97 @@ struct SortOrderWrapper {
     }
 };
 
+/// One aggregate requested by results_aggregate_many(). Mirrors NativeResults.AggregateRequest.
+struct MarshallableAggregateRequest {
+    size_t column;
+    size_t op; // a Results::AggregateOp
+};
+
+/// The value of one aggregate from results_aggregate_many(). Mirrors NativeResults.AggregateResult.
+struct MarshallableAggregateResult {
+    int64_t int_value;      // int values, and date values as seconds since the epoch
+    double double_value;    // float and double values, including all averages
+    int32_t type;           // the DataType of the value
+    int32_t has_value;      // 0 if the aggregate has no value, e.g. the minimum of no rows
+};
+
+namespace {
+
+// Clamp a requested [begin_ndx, begin_ndx + count) range to the results and copy the
+// values in it, in result order, with copy_column_values()
+template <typename T, typename Getter>
+size_t copy_results_column_range(Results* results_ptr, size_t column_ndx, size_t begin_ndx, size_t count,
+                                 T* values, uint8_t* nulls, Getter&& get)
+{
+    const size_t size = results_ptr->size();
+    if (begin_ndx > size)
+        throw IndexOutOfRangeException("Read column range", begin_ndx, size);
+    count = std::min(count, size - begin_ndx);
+
+    // Row::is_null() is false for non-nullable columns, so it is safe to always check it
+    // rather than finding an attached row to ask the table about the column
+    copy_column_values(column_ndx, true, count,
+                       [&](size_t i) { return results_ptr->get(begin_ndx + i); },
+                       std::forward<Getter>(get), values, nulls);
+    return count;
+}
+
+MarshallableAggregateResult marshal_aggregate(const util::Optional<Mixed>& value)
+{
+    MarshallableAggregateResult result = {};
+    if (!value)
+        return result;
+
+    result.has_value = 1;
+    result.type = value->get_type();
+    switch (value->get_type()) {
+        case type_Int:
+            result.int_value = value->get_int();
+            break;
+        case type_Float:
+            result.double_value = value->get_float();
+            break;
+        case type_Double:
+            result.double_value = value->get_double();
+            break;
+        case type_DateTime:
+            result.int_value = value->get_datetime().get_datetime();
+            break;
+        default:
+            REALM_UNREACHABLE();
+    }
+    return result;
+}
+
+MarshallableCollectionChangeSet::MarshallableIndexSet marshal_index_set(const IndexSet& index_set,
+    std::vector<MarshallableCollectionChangeSet::MarshallableIndexSet::Chunk>& chunks)
+{
+    size_t index_count = 0;
+    for (auto& chunk : index_set.chunks()) {
+        chunks.push_back({ chunk.data.data(), chunk.data.size() });
+        index_count += chunk.count;
+    }
+    return { chunks.data(), chunks.size(), index_count };
+}
+
+} // anonymous namespace
+
+namespace realm {
+namespace binding {
+
+MarshalledCollectionChangeSet::MarshalledCollectionChangeSet(CollectionChangeSet changes)
+: m_changes(std::move(changes))
+{
+    m_marshallable = {
+        marshal_index_set(m_changes.deletions, m_deletions),
+        marshal_index_set(m_changes.insertions, m_insertions),
+        marshal_index_set(m_changes.modifications, m_modifications),
+        { m_changes.moves.data(), m_changes.moves.size() }
+    };
+}
+
+}
+}
 
 extern "C" {
 
@@ -86,15 +180,150 @@ REALM_EXPORT Results* results_create_for_query_sorted(SharedRealm* realm, Query
   });
 }
 
+// Creates a Results holding only the first max_count rows of results_ptr, sorting only the rows
+// which can be among them rather than the whole query
+REALM_EXPORT Results* results_create_limited(Results* results_ptr, size_t max_count)
+{
+  return handle_errors([&]() {
+      return new Results(results_ptr->limit(max_count));
+  });
+}
+
+// Creates a Results holding the length rows of results_ptr starting at offset. Indices passed to and
+// change sets reported by the new Results are relative to offset.
+REALM_EXPORT Results* results_create_window(Results* results_ptr, size_t offset, size_t length)
+{
+  return handle_errors([&]() {
+      return new Results(results_ptr->window(offset, length));
+  });
+}
+
 REALM_EXPORT Row* results_get_row(Results* results_ptr, size_t ndx)
+{
+  return handle_errors([&]() -> Row* {
+    // running off the end is how enumeration finishes, so check rather than letting get() throw
+    auto row = results_ptr->try_get(ndx);
+    if (!row)
+      return nullptr;
+    return new Row(*row);
+  });
+}
+
+// Status code alternative to results_get_row, see NativeStatus in error_handling.hpp
+REALM_EXPORT NativeStatus results_try_get_row(Results* results_ptr, size_t ndx, Row*& row)
+{
+  return handle_errors_status([&]() {
+    row = nullptr;
+    auto result = results_ptr->try_get(ndx);
+    if (!result)
+      return NativeStatus::IndexOutOfRange;
+    row = new Row(*result);
+    return NativeStatus::Ok;
+  });
+}
+
+// See table_get_column_range_* in table_cs.cpp
+REALM_EXPORT size_t results_get_column_range_bool(Results* results_ptr, size_t column_ndx, size_t begin_ndx, size_t count, uint8_t* values, uint8_t* nulls)
+{
+  return handle_errors([&]() {
+    return copy_results_column_range(results_ptr, column_ndx, begin_ndx, count, values, nulls,
+                                     [=](auto const& row) { return uint8_t(row.get_bool(column_ndx)); });
+  });
+}
+
+REALM_EXPORT size_t results_get_column_range_int64(Results* results_ptr, size_t column_ndx, size_t begin_ndx, size_t count, int64_t* values, uint8_t* nulls)
+{
+  return handle_errors([&]() {
+    return copy_results_column_range(results_ptr, column_ndx, begin_ndx, count, values, nulls,
+                                     [=](auto const& row) { return row.get_int(column_ndx); });
+  });
+}
+
+REALM_EXPORT size_t results_get_column_range_float(Results* results_ptr, size_t column_ndx, size_t begin_ndx, size_t count, float* values, uint8_t* nulls)
 {
   return handle_errors([&]() {
-    try {
-      return new Row(results_ptr->get(ndx));
+    return copy_results_column_range(results_ptr, column_ndx, begin_ndx, count, values, nulls,
+                                     [=](auto const& row) { return row.get_float(column_ndx); });
+  });
+}
+
+REALM_EXPORT size_t results_get_column_range_double(Results* results_ptr, size_t column_ndx, size_t begin_ndx, size_t count, double* values, uint8_t* nulls)
+{
+  return handle_errors([&]() {
+    return copy_results_column_range(results_ptr, column_ndx, begin_ndx, count, values, nulls,
+                                     [=](auto const& row) { return row.get_double(column_ndx); });
+  });
+}
+
+REALM_EXPORT size_t results_get_column_range_datetime_seconds(Results* results_ptr, size_t column_ndx, size_t begin_ndx, size_t count, int64_t* values, uint8_t* nulls)
+{
+  return handle_errors([&]() {
+    return copy_results_column_range(results_ptr, column_ndx, begin_ndx, count, values, nulls,
+                                     [=](auto const& row) { return int64_t(row.get_datetime(column_ndx).get_datetime()); });
+  });
+}
+
+// Copies the table row indices of up to count rows starting at begin_ndx into row_indices and
+// returns how many were copied. Together with table_version these let C# read the rows with the
+// table_get_* functions without allocating a Row per element; rows which have been deleted are
+// reported as npos. Any write to the table invalidates all of the indices, even those of rows the
+// write didn't touch, which the caller can check for once per batch with table_are_valid_row_references.
+REALM_EXPORT size_t results_get_row_indices(Results* results_ptr, size_t begin_ndx, size_t count, size_t* row_indices, uint64_t& table_version)
+{
+  return handle_errors([&]() {
+    const size_t size = results_ptr->size();
+    if (begin_ndx > size)
+      throw IndexOutOfRangeException("Get row indices", begin_ndx, size);
+    count = std::min(count, size - begin_ndx);
+
+    for (size_t i = 0; i < count; ++i) {
+      auto row = results_ptr->get(begin_ndx + i);
+      row_indices[i] = row.is_attached() ? row.get_index() : npos;
     }
-    catch (std::out_of_range &exp) {
-      return (Row*)nullptr;
+    Table* table = results_ptr->get_table();
+    table_version = table ? get_table_version(*table) : 0;
+    return count;
+  });
+}
+
+REALM_EXPORT void results_set_parallel_evaluation(Results* results_ptr, size_t parallel)
+{
+  handle_errors([&]() {
+    results_ptr->set_parallel_evaluation(size_t_to_bool(parallel));
+  });
+}
+
+// Runs the query on the coordinator's worker threads and copies the table row indices of the matches
+// into row_indices. Returns the total number of matches; if that's more than bufsize, only the first
+// bufsize were copied and the caller should retry with a larger buffer.
+REALM_EXPORT size_t results_find_all_row_indices_parallel(Results* results_ptr, size_t* row_indices, size_t bufsize, uint64_t& table_version)
+{
+  return handle_errors([&]() {
+    auto rows = results_ptr->find_all_row_indices_parallel();
+    std::copy(rows.begin(), rows.begin() + std::min(bufsize, rows.size()), row_indices);
+    Table* table = results_ptr->get_table();
+    table_version = table ? get_table_version(*table) : 0;
+    return rows.size();
+  });
+}
+
+// Computes count aggregates over the results in a single pass over the rows, writing
+// each one's value to the corresponding element of results
+REALM_EXPORT void results_aggregate_many(Results* results_ptr, const MarshallableAggregateRequest* requests, size_t count,
+                                         MarshallableAggregateResult* results)
+{
+  handle_errors([&]() {
+    std::vector<Results::Aggregate> aggregates;
+    aggregates.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      if (requests[i].op > size_t(Results::AggregateOp::Average))
+        throw std::invalid_argument("Unknown aggregate operation");
+      aggregates.push_back({ requests[i].column, Results::AggregateOp(requests[i].op) });
     }
+
+    auto values = results_ptr->aggregate_many(aggregates);
+    for (size_t i = 0; i < count; ++i)
+      results[i] = marshal_aggregate(values[i]);
   });
 }
 
@@ -136,37 +365,30 @@ REALM_EXPORT void sortorder_add_clause(SortOrderWrapper* sortorder_ptr, uint16_t
   });
 }
 
-struct MarshallableCollectionChangeSet {
-    struct MarshallableIndexSet {
-        size_t* indices;
-        size_t count;
-    };
-    
-    MarshallableIndexSet deletions;
-    MarshallableIndexSet insertions;
-    MarshallableIndexSet modifications;
-    
-    struct {
-        CollectionChangeSet::Move* moves;
-        size_t count;
-    } moves;
-};
-
 typedef void (*ManagedNotificationCallback)(void* managed_results, MarshallableCollectionChangeSet*, NativeException::Marshallable*);
 
 struct ManagedNotificationTokenContext {
   NotificationToken token;
   void* managed_results;
   ManagedNotificationCallback callback;
+  // used to find the Realm's CSharpBindingContext, which may want to batch up the notification
+  std::weak_ptr<Realm> realm;
 };
     
-REALM_EXPORT ManagedNotificationTokenContext* results_add_notification_callback(Results* results_ptr, void* managed_results, ManagedNotificationCallback callback)
+REALM_EXPORT ManagedNotificationTokenContext* results_add_notification_callback(Results* results_ptr, void* managed_results, ManagedNotificationCallback callback, NotificationPriority priority)
 {
   return handle_errors([=]() {
     auto context = new ManagedNotificationTokenContext();
     context->managed_results = managed_results;
     context->callback = callback;
+    context->realm = results_ptr->get_realm();
     context->token = std::move(results_ptr->add_notification_callback([context](CollectionChangeSet changes, std::exception_ptr e) {
+      if (auto realm = context->realm.lock()) {
+        auto binding_context = static_cast<CSharpBindingContext*>(realm->m_binding_context.get());
+        if (binding_context && binding_context->add_to_batch(context->managed_results, changes, e))
+          return;
+      }
+
       if (e) {
         try {
           std::rethrow_exception(e);
@@ -178,19 +400,10 @@ REALM_EXPORT ManagedNotificationTokenContext* results_add_notification_callback(
       } else if (changes.empty()) {
         context->callback(context->managed_results, nullptr, nullptr);
       } else {
-        std::vector<size_t> deletions(changes.deletions.as_indexes().begin(), changes.deletions.as_indexes().end());
-        std::vector<size_t> insertions(changes.insertions.as_indexes().begin(), changes.insertions.as_indexes().end());
-        std::vector<size_t> modifications(changes.modifications.as_indexes().begin(), changes.modifications.as_indexes().end());
-        
-        MarshallableCollectionChangeSet marshallable_changes {
-          { deletions.data(), deletions.size() },
-          { insertions.data(), insertions.size() },
-          { modifications.data(), modifications.size() },
-          { changes.moves.data(), changes.moves.size() }
-        };
-        context->callback(context->managed_results, &marshallable_changes, nullptr);
+        MarshalledCollectionChangeSet marshalled_changes(std::move(changes));
+        context->callback(context->managed_results, marshalled_changes.get(), nullptr);
       }
-    }));
+    }, priority));
 
     return context;
   });
@@ -205,4 +418,59 @@ REALM_EXPORT void* results_destroy_notificationtoken(ManagedNotificationTokenCon
   });
 }
 
+// values points to the count, min, max, sum and average, in Results::AggregateOp order
+typedef void (*ManagedAggregateCallback)(void* managed_handle, const MarshallableAggregateResult* values, NativeException::Marshallable*);
+
+struct ManagedLiveAggregateContext {
+  ManagedLiveAggregateContext(Results const& results, size_t column) : aggregate(results, column) {}
+
+  LiveAggregate aggregate;
+  NotificationToken token;
+  void* managed_handle;
+  ManagedAggregateCallback callback;
+};
+
+// Calls callback with the aggregates of the column each time they change, keeping them up to date
+// on the background thread rather than recomputing them from every row
+REALM_EXPORT ManagedLiveAggregateContext* results_add_aggregate_callback(Results* results_ptr, size_t column, void* managed_handle, ManagedAggregateCallback callback)
+{
+  return handle_errors([=]() {
+    auto context = new ManagedLiveAggregateContext(*results_ptr, column);
+    context->managed_handle = managed_handle;
+    context->callback = callback;
+    context->token = context->aggregate.add_notification_callback([context](LiveAggregate::Values const& values, std::exception_ptr e) {
+      if (e) {
+        try {
+          std::rethrow_exception(e);
+        } catch (...) {
+          auto exception = convert_exception();
+          auto marshallable_exception = exception.for_marshalling();
+          context->callback(context->managed_handle, nullptr, &marshallable_exception);
+        }
+        return;
+      }
+
+      MarshallableAggregateResult marshalled[] = {
+        marshal_aggregate(Mixed(int64_t(values.count))),
+        marshal_aggregate(values.min),
+        marshal_aggregate(values.max),
+        marshal_aggregate(values.sum),
+        marshal_aggregate(values.average)
+      };
+      context->callback(context->managed_handle, marshalled, nullptr);
+    });
+
+    return context;
+  });
+}
+
+REALM_EXPORT void* results_destroy_aggregate_callback(ManagedLiveAggregateContext* context_ptr)
+{
+  return handle_errors([&]() {
+    void* managed_handle = context_ptr->managed_handle;
+    delete context_ptr;
+    return managed_handle;
+  });
+}
+
 }   // extern "C"
@@ -21,9 +21,11 @@
 #include "error_handling.hpp"
 #include "realm_export_decls.hpp"
 #include "marshalling.hpp"
+#include "notifications_cs.hpp"
 #include "object-store/src/shared_realm.hpp"
 #include "object-store/src/schema.hpp"
 #include "object-store/src/binding_context.hpp"
+#include "object-store/src/impl/weak_realm_notifier.hpp"
 #include <list>
 
 
@@ -32,26 +34,83 @@ using namespace realm::binding;
 
 using NotifyRealmChangedT = void(*)(void* managed_realm_handle);
 NotifyRealmChangedT notify_realm_changed = nullptr;
+ManagedBatchNotificationCallback notify_results_batch = nullptr;
 
 namespace realm {
 namespace binding {
 
-class CSharpBindingContext: public BindingContext {
-public:
-    CSharpBindingContext(void* managed_realm_handle) : m_managed_realm_handle(managed_realm_handle) {}
-
-    void did_change(std::vector<ObserverState> const&, std::vector<void*> const&) override
-    {
+void CSharpBindingContext::did_change(std::vector<ObserverState> const&, std::vector<void*> const&)
+{
+    // the binding context may only have been created for batched notifications
+    if (m_managed_realm_handle)
         notify_realm_changed(m_managed_realm_handle);
+}
+
+void CSharpBindingContext::will_send_notifications()
+{
+    m_sending_notifications = m_batch_notifications && notify_results_batch;
+}
+
+bool CSharpBindingContext::add_to_batch(void* managed_results, CollectionChangeSet& changes, std::exception_ptr error)
+{
+    if (!m_sending_notifications)
+        return false;
+
+    bool has_changes = !changes.empty();
+    m_pending.emplace_back(managed_results, std::move(changes));
+    auto& pending = m_pending.back();
+    pending.has_changes = has_changes;
+    if (error) {
+        try {
+            std::rethrow_exception(error);
+        }
+        catch (...) {
+            pending.error = convert_exception();
+        }
+        pending.has_error = true;
+        pending.marshallable_error = pending.error.for_marshalling();
     }
+    return true;
+}
+
+void CSharpBindingContext::did_send_notifications()
+{
+    if (!m_sending_notifications)
+        return;
+    m_sending_notifications = false;
+    if (m_pending.empty())
+        return;
 
-private:
-    void* m_managed_realm_handle;
-};
+    // managed code may refresh the Realm from within the callback, which starts a new batch
+    std::deque<PendingNotification> pending;
+    pending.swap(m_pending);
+
+    std::vector<MarshallableNotification> notifications;
+    notifications.reserve(pending.size());
+    for (auto& notification : pending) {
+        notifications.push_back({
+            notification.managed_results,
+            notification.has_changes ? notification.changes.get() : nullptr,
+            notification.has_error ? &notification.marshallable_error : nullptr
+        });
+    }
+    notify_results_batch(m_managed_realm_handle, notifications.data(), notifications.size());
+}
 
 }
 }
 
+namespace {
+
+CSharpBindingContext& get_binding_context(SharedRealm& realm)
+{
+    if (!realm->m_binding_context)
+        realm->m_binding_context = std::unique_ptr<realm::BindingContext>(new CSharpBindingContext(nullptr));
+    return static_cast<CSharpBindingContext&>(*realm->m_binding_context);
+}
+
+} // anonymous namespace
+
 extern "C" {
 
 REALM_EXPORT void register_notify_realm_changed(NotifyRealmChangedT notifier)
@@ -59,6 +118,11 @@ REALM_EXPORT void register_notify_realm_changed(NotifyRealmChangedT notifier)
     notify_realm_changed = notifier;
 }
 
+REALM_EXPORT void register_notify_results_batch(ManagedBatchNotificationCallback notifier)
+{
+    notify_results_batch = notifier;
+}
+
 REALM_EXPORT SharedRealm* shared_realm_open(Schema* schema, uint16_t* path, size_t path_len, bool read_only, SharedGroup::DurabilityLevel durability,
                         uint8_t* encryption_key, uint64_t schemaVersion)
 {
@@ -87,7 +151,16 @@ REALM_EXPORT SharedRealm* shared_realm_open(Schema* schema, uint16_t* path, size
 REALM_EXPORT void shared_realm_bind_to_managed_realm_handle(SharedRealm* realm, void* managed_realm_handle)
 {
     handle_errors([&]() {
-        (*realm)->m_binding_context = std::unique_ptr<realm::BindingContext>(new CSharpBindingContext(managed_realm_handle));
+        get_binding_context(*realm).set_managed_realm_handle(managed_realm_handle);
+    });
+}
+
+// Deliver all of the Results notifications for this Realm which become ready together in a single call to the
+// callback registered with register_notify_results_batch, rather than through each Results' own callback
+REALM_EXPORT void shared_realm_set_batch_notifications(SharedRealm* realm, size_t batch)
+{
+    handle_errors([&]() {
+        get_binding_context(*realm).set_batch_notifications(size_t_to_bool(batch));
     });
 }
 
@@ -127,6 +200,45 @@ REALM_EXPORT uint64_t  shared_realm_get_schema_version(SharedRealm* realm)
     });
 }
 
+// Resolves the column index of each of the property_count properties of object_type named in
+// property_names into column_indices, so that the managed side can look up all of its columns
+// with one call rather than on every query. property_names holds the names back to back, with
+// the length of name i in property_name_lengths[i]. Returns the number of properties object_type
+// has in the schema, and sets schema_version to the version the indices belong to; the indices
+// stay valid for as long as the Realm is open, as its schema version can't change until then.
+REALM_EXPORT size_t shared_realm_get_column_map(SharedRealm* realm, uint16_t* object_type, size_t object_type_len,
+                                                uint16_t* property_names, const size_t* property_name_lengths,
+                                                size_t property_count, size_t* column_indices, uint64_t& schema_version)
+{
+    return handle_errors([&]() {
+        Utf16StringAccessor type_name(object_type, object_type_len);
+        auto& config = (*realm)->config();
+        if (!config.schema)
+            throw std::logic_error("Realm was opened without a schema");
+        auto object_schema = config.schema->find(type_name.to_string());
+        if (object_schema == config.schema->end())
+            throw std::invalid_argument("Object type '" + type_name.to_string() + "' is not in the schema");
+
+        for (size_t i = 0; i < property_count; ++i) {
+            Utf16StringAccessor name(property_names, property_name_lengths[i]);
+            property_names += property_name_lengths[i];
+            auto property = object_schema->property_for_name(name);
+            if (!property)
+                throw std::invalid_argument("Property '" + name.to_string() + "' of '" + type_name.to_string() + "' is not in the schema");
+            column_indices[i] = property->table_column;
+        }
+        schema_version = config.schema_version;
+        return object_schema->properties.size();
+    });
+}
+
+REALM_EXPORT size_t shared_realm_is_column_map_current(SharedRealm* realm, uint64_t schema_version)
+{
+    return handle_errors([&]() {
+        return bool_to_size_t((*realm)->config().schema_version == schema_version);
+    });
+}
+
 REALM_EXPORT void shared_realm_begin_transaction(SharedRealm* realm)
 {
     handle_errors([&]() {
@@ -170,4 +282,30 @@ REALM_EXPORT size_t shared_realm_refresh(SharedRealm* realm)
     });
 }
 
+// On Linux, Realms are not refreshed automatically when another thread or process commits. Instead the eventfd
+// returned here becomes readable, and the thread should then call shared_realm_drain_thread_notifications() from
+// its event loop to refresh all of the Realms it has open in one go. Returns -1 on other platforms.
+REALM_EXPORT int32_t shared_realm_get_thread_notification_fd()
+{
+    return handle_errors([&]() -> int32_t {
+#if defined(__linux__) && !REALM_ANDROID
+        return _impl::WeakRealmNotifier::get_thread_notification_fd();
+#else
+        return -1;
+#endif
+    });
+}
+
+// returns the number of Realms which were notified
+REALM_EXPORT size_t shared_realm_drain_thread_notifications()
+{
+    return handle_errors([&]() -> size_t {
+#if defined(__linux__) && !REALM_ANDROID
+        return _impl::WeakRealmNotifier::drain_thread_notifications();
+#else
+        return 0;
+#endif
+    });
+}
+
 }
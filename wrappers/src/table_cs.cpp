@@ -22,12 +22,79 @@
 #include "marshalling.hpp"
 #include "realm_export_decls.hpp"
 #include "shared_linklist.hpp"
+#include "wrapper_exceptions.hpp"
 
 #include <memory>
 
 using namespace realm;
 using namespace realm::binding;
 
+namespace {
+
+// Clamp a requested [begin_row_ndx, begin_row_ndx + count) range to the table
+// and copy the values in it with copy_column_values()
+template <typename T, typename Getter>
+size_t copy_table_column_range(const Table* table_ptr, size_t column_ndx, size_t begin_row_ndx, size_t count,
+                               T* values, uint8_t* nulls, Getter&& get)
+{
+    const size_t size = table_ptr->size();
+    if (begin_row_ndx > size)
+        throw IndexOutOfRangeException("Read column range", begin_row_ndx, size);
+    count = std::min(count, size - begin_row_ndx);
+
+    copy_column_values(column_ndx, table_ptr->is_nullable(column_ndx), count,
+                       [&](size_t i) { return (*table_ptr)[begin_row_ndx + i]; },
+                       std::forward<Getter>(get), values, nulls);
+    return count;
+}
+
+/// One column of packed values for table_bulk_insert(). Which of the fields are used
+/// depends on the type of the column:
+/// * bool: values points to row_count uint8_t
+/// * int, datetime (seconds): values points to row_count int64_t
+/// * float, double: values points to row_count float/double
+/// * string: values points to the UTF-16 data of all the strings, and row i is the
+///   string_lengths[i] code units starting at string_offsets[i]
+/// nulls is optional, and is a bitmap of (row_count + 7) / 8 bytes where bit i is set
+/// if row i should be null rather than the value in values.
+struct BulkInsertColumn {
+    size_t column_ndx;
+    const void* values;
+    const size_t* string_offsets;
+    const size_t* string_lengths;
+    const uint8_t* nulls;
+};
+
+inline bool bitmap_is_set(const uint8_t* bitmap, size_t i)
+{
+    return bitmap && (bitmap[i / 8] & (1 << (i % 8)));
+}
+
+// Size of the UTF-8 encoding of [begin, end), or npos if it isn't valid UTF-16.
+// Doesn't transcode anything, so that a bulk insert can be validated before
+// any rows are added without holding on to the converted strings.
+inline size_t utf8_size(const uint16_t* begin, const uint16_t* end)
+{
+    typedef realm::util::Utf8x16<uint16_t, std::char_traits<char16_t>> Xcode;
+    if (is_ascii(begin, end))
+        return end - begin;
+    size_t size = Xcode::find_utf8_buf_size(begin, end);
+    return begin == end ? size : npos;
+}
+
+template <typename T, typename Setter>
+void fill_column(Table& table, BulkInsertColumn const& column, size_t begin_row_ndx, size_t row_count, Setter&& set)
+{
+    auto values = static_cast<const T*>(column.values);
+    for (size_t i = 0; i < row_count; ++i) {
+        if (bitmap_is_set(column.nulls, i))
+            table.set_null(column.column_ndx, begin_row_ndx + i);
+        else
+            set(begin_row_ndx + i, values[i]);
+    }
+}
+
+} // anonymous namespace
 
 extern "C" {
 
@@ -54,6 +121,101 @@ REALM_EXPORT Row* table_add_empty_row(Table* table_ptr)
     });
 }
 
+// Adds row_count rows in one go and fills them column by column from the packed buffers
+// described by columns, so that inserting many objects doesn't need a p/invoke and a Row
+// allocation per row plus one p/invoke per property. Columns not mentioned keep their
+// default values. Returns the index of the first added row.
+REALM_EXPORT size_t table_bulk_insert(Table* table_ptr, size_t row_count, const BulkInsertColumn* columns, size_t column_count)
+{
+    return handle_errors([&]() {
+        // validate everything up front, so that nothing can fail once the rows
+        // have been added. The strings are only transcoded as they're set.
+        if (column_count && !columns)
+            throw std::invalid_argument("No column descriptors for bulk insert");
+        for (size_t c = 0; c < column_count; ++c) {
+            auto& column = columns[c];
+            if (column.column_ndx >= table_ptr->get_column_count())
+                throw IndexOutOfRangeException("Bulk insert column", column.column_ndx, table_ptr->get_column_count());
+            if (row_count && !column.values)
+                throw std::invalid_argument("No values for bulk insert column");
+            if (column.nulls && !table_ptr->is_nullable(column.column_ndx))
+                throw std::invalid_argument("Column is not nullable");
+            switch (table_ptr->get_column_type(column.column_ndx)) {
+                case type_Bool: case type_Int: case type_Float: case type_Double: case type_DateTime:
+                    break;
+                case type_String: {
+                    if (row_count && (!column.string_offsets || !column.string_lengths))
+                        throw std::invalid_argument("No string offsets or lengths for bulk insert column");
+                    auto chars = static_cast<const uint16_t*>(column.values);
+                    for (size_t i = 0; i < row_count; ++i) {
+                        if (bitmap_is_set(column.nulls, i))
+                            continue;
+                        auto begin = chars + column.string_offsets[i];
+                        size_t size = utf8_size(begin, begin + column.string_lengths[i]);
+                        if (size == npos)
+                            throw std::invalid_argument("Invalid UTF-16 string for bulk insert");
+                        if (size > Table::max_string_size)
+                            throw std::invalid_argument("String too long for bulk insert");
+                    }
+                    break;
+                }
+                default:
+                    throw std::invalid_argument("Unsupported column type for bulk insert");
+            }
+        }
+
+        const size_t begin_row_ndx = table_ptr->add_empty_row(row_count);
+        Table& table = *table_ptr;
+
+        for (size_t c = 0; c < column_count; ++c) {
+            auto& column = columns[c];
+            const size_t col = column.column_ndx;
+            switch (table.get_column_type(col)) {
+                case type_Bool:
+                    fill_column<uint8_t>(table, column, begin_row_ndx, row_count, [&](size_t row, uint8_t value) {
+                        table.set_bool(col, row, value != 0);
+                    });
+                    break;
+                case type_Int:
+                    fill_column<int64_t>(table, column, begin_row_ndx, row_count, [&](size_t row, int64_t value) {
+                        table.set_int(col, row, value);
+                    });
+                    break;
+                case type_Float:
+                    fill_column<float>(table, column, begin_row_ndx, row_count, [&](size_t row, float value) {
+                        table.set_float(col, row, value);
+                    });
+                    break;
+                case type_Double:
+                    fill_column<double>(table, column, begin_row_ndx, row_count, [&](size_t row, double value) {
+                        table.set_double(col, row, value);
+                    });
+                    break;
+                case type_DateTime:
+                    fill_column<int64_t>(table, column, begin_row_ndx, row_count, [&](size_t row, int64_t value) {
+                        table.set_datetime(col, row, DateTime(value));
+                    });
+                    break;
+                case type_String: {
+                    auto chars = static_cast<const uint16_t*>(column.values);
+                    for (size_t i = 0; i < row_count; ++i) {
+                        if (bitmap_is_set(column.nulls, i)) {
+                            table.set_null(col, begin_row_ndx + i);
+                            continue;
+                        }
+                        Utf16StringAccessor str(const_cast<uint16_t*>(chars + column.string_offsets[i]), column.string_lengths[i]);
+                        table.set_string(col, begin_row_ndx + i, str);
+                    }
+                    break;
+                }
+                default:
+                    REALM_UNREACHABLE();
+            }
+        }
+        return begin_row_ndx;
+    });
+}
+
 REALM_EXPORT Row* table_get_link(Table* table_ptr, size_t column_ndx, size_t row_ndx)
 {
   return handle_errors([&]() -> Row* {
@@ -65,6 +227,64 @@ REALM_EXPORT Row* table_get_link(Table* table_ptr, size_t column_ndx, size_t row
   });
 }
 
+// Status code alternative to table_get_link which reports a null link as NativeStatus::NotFound
+REALM_EXPORT NativeStatus table_try_get_link(Table* table_ptr, size_t column_ndx, size_t row_ndx, Row*& row)
+{
+  return handle_errors_status([&]() {
+    row = nullptr;
+    const size_t link_row_ndx = table_ptr->get_link(column_ndx, row_ndx);
+    if (link_row_ndx == realm::npos)
+      return NativeStatus::NotFound;
+    auto target_table_ptr = table_ptr->get_link_target(column_ndx);
+    row = new Row((*target_table_ptr)[link_row_ndx]);
+    return NativeStatus::Ok;
+  });
+}
+
+// Handle-free alternative to table_get_link: returns the row index in the target table, or npos
+REALM_EXPORT size_t table_get_link_row_index(const Table* table_ptr, size_t column_ndx, size_t row_ndx)
+{
+  return handle_errors([&]() {
+    return table_ptr->get_link(column_ndx, row_ndx);
+  });
+}
+
+// The version row indices handed out by results_get_row_indices and results_find_all_row_indices_parallel
+// are valid for. Any write to the table changes it, invalidating every row index handed out before the write.
+REALM_EXPORT uint64_t table_get_version(Table* table_ptr)
+{
+    return handle_errors([&]() {
+        return get_table_version(*table_ptr);
+    });
+}
+
+// Checks that a row index handed out along with a table version (e.g. by results_get_row_indices)
+// still refers to the same row. Any write to the table invalidates every row index handed out before it.
+// Use table_are_valid_row_references to check several rows, as getting the table's version isn't free.
+REALM_EXPORT size_t table_is_valid_row_reference(Table* table_ptr, size_t row_ndx, uint64_t version)
+{
+    return handle_errors([&]() {
+        return bool_to_size_t(table_ptr->is_attached() &&
+                              is_valid_row_reference(*table_ptr, row_ndx, version, get_table_version(*table_ptr)));
+    });
+}
+
+// Checks count row indices handed out along with the same table version, setting valid[i] to 1 if
+// row_indices[i] still refers to the same row and 0 otherwise. The table's version is only read once.
+REALM_EXPORT void table_are_valid_row_references(Table* table_ptr, const size_t* row_indices, size_t count,
+                                                 uint64_t version, uint8_t* valid)
+{
+    handle_errors([&]() {
+        if (!table_ptr->is_attached()) {
+            std::fill(valid, valid + count, uint8_t(0));
+            return;
+        }
+        const uint64_t current_version = get_table_version(*table_ptr);
+        for (size_t i = 0; i < count; ++i)
+            valid[i] = is_valid_row_reference(*table_ptr, row_indices[i], version, current_version);
+    });
+}
+
 REALM_EXPORT SharedLinkViewRef* table_get_linklist(Table* table_ptr, size_t column_ndx, size_t row_ndx)
 {
   return handle_errors([&]() -> SharedLinkViewRef* {
@@ -158,6 +378,25 @@ REALM_EXPORT size_t table_get_string(const Table* table_ptr, size_t column_ndx,
     });
 }
 
+// Like table_get_string, but instead of copying the string into a buffer supplied by C# (and asking to be
+// called again if it is too small) this points value at the UTF-16 form of the string, which stays valid
+// until the next string read on this thread. Returns the length in 16 bit characters, or -1 for bad UTF-8.
+REALM_EXPORT size_t table_get_string_ptr(const Table* table_ptr, size_t column_ndx, size_t row_ndx, const uint16_t** value, bool* is_null)
+{
+    return handle_errors([&]() -> size_t {
+        StringData fielddata = table_ptr->get_string(column_ndx, row_ndx);
+        *value = nullptr;
+        if ((*is_null = fielddata.is_null()) || fielddata.size() == 0)
+            return 0;
+
+        auto utf16 = Utf16StringCache::get_for_current_thread().get(fielddata);
+        if (!utf16)
+            return -1;
+        *value = utf16->data();
+        return utf16->size();
+    });
+}
+
 REALM_EXPORT int64_t table_get_datetime_seconds(const Table* table_ptr, size_t column_ndx, size_t row_ndx)
 {
     return handle_errors([&]() {
@@ -176,6 +415,50 @@ REALM_EXPORT size_t table_get_nullable_datetime_seconds(const Table* table_ptr,
     });
 }
 
+// The table_get_column_range_* functions copy up to count values of a single column, starting at
+// begin_row_ndx, into values, and return the number of values actually copied (which is less than
+// count if the range runs past the end of the table). nulls is optional; see copy_column_values()
+// for its layout.
+REALM_EXPORT size_t table_get_column_range_bool(const Table* table_ptr, size_t column_ndx, size_t begin_row_ndx, size_t count, uint8_t* values, uint8_t* nulls)
+{
+    return handle_errors([&]() {
+        return copy_table_column_range(table_ptr, column_ndx, begin_row_ndx, count, values, nulls,
+                                       [=](auto const& row) { return uint8_t(row.get_bool(column_ndx)); });
+    });
+}
+
+REALM_EXPORT size_t table_get_column_range_int64(const Table* table_ptr, size_t column_ndx, size_t begin_row_ndx, size_t count, int64_t* values, uint8_t* nulls)
+{
+    return handle_errors([&]() {
+        return copy_table_column_range(table_ptr, column_ndx, begin_row_ndx, count, values, nulls,
+                                       [=](auto const& row) { return row.get_int(column_ndx); });
+    });
+}
+
+REALM_EXPORT size_t table_get_column_range_float(const Table* table_ptr, size_t column_ndx, size_t begin_row_ndx, size_t count, float* values, uint8_t* nulls)
+{
+    return handle_errors([&]() {
+        return copy_table_column_range(table_ptr, column_ndx, begin_row_ndx, count, values, nulls,
+                                       [=](auto const& row) { return row.get_float(column_ndx); });
+    });
+}
+
+REALM_EXPORT size_t table_get_column_range_double(const Table* table_ptr, size_t column_ndx, size_t begin_row_ndx, size_t count, double* values, uint8_t* nulls)
+{
+    return handle_errors([&]() {
+        return copy_table_column_range(table_ptr, column_ndx, begin_row_ndx, count, values, nulls,
+                                       [=](auto const& row) { return row.get_double(column_ndx); });
+    });
+}
+
+REALM_EXPORT size_t table_get_column_range_datetime_seconds(const Table* table_ptr, size_t column_ndx, size_t begin_row_ndx, size_t count, int64_t* values, uint8_t* nulls)
+{
+    return handle_errors([&]() {
+        return copy_table_column_range(table_ptr, column_ndx, begin_row_ndx, count, values, nulls,
+                                       [=](auto const& row) { return int64_t(row.get_datetime(column_ndx).get_datetime()); });
+    });
+}
+
 REALM_EXPORT void table_set_link(Table* table_ptr, size_t column_ndx, size_t row_ndx, size_t target_row_ndx)
 {
     return handle_errors([&]() {
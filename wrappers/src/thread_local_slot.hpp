@@ -0,0 +1,60 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef THREAD_LOCAL_SLOT_HPP
+#define THREAD_LOCAL_SLOT_HPP
+
+#include <memory>
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
+namespace realm {
+namespace binding {
+
+//returns the calling thread's instance of T, which is default constructed on first use if create is set
+//(otherwise nullptr is returned until then) and destroyed when the thread exits.
+template <typename T>
+T* thread_local_instance(bool create = true)
+{
+#ifdef WIN32
+    static thread_local std::unique_ptr<T> instance;
+    if (!instance && create)
+        instance.reset(new T());
+    return instance.get();
+#else
+    //C++11 thread_local isn't available for the iOS versions we target, so use a pthread key
+    static pthread_key_t key;
+    static pthread_once_t key_once = PTHREAD_ONCE_INIT;
+    pthread_once(&key_once, [] {
+        pthread_key_create(&key, [](void* instance) { delete static_cast<T*>(instance); });
+    });
+
+    auto instance = static_cast<T*>(pthread_getspecific(key));
+    if (!instance && create) {
+        instance = new T();
+        pthread_setspecific(key, instance);
+    }
+    return instance;
+#endif
+}
+
+} // namespace binding
+} // namespace realm
+
+#endif // THREAD_LOCAL_SLOT_HPP